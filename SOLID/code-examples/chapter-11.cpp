@@ -5,6 +5,10 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
 using namespace std;
 
 // Observer Pattern - Notification system
@@ -55,6 +59,24 @@ public:
 class PaymentStrategy {
 public:
     virtual void pay(double amount) = 0;
+    
+    // Batch API: one provider round-trip for many carts, one result per amount.
+    // The default keeps existing strategies working by paying one at a time;
+    // a pay() that throws counts as declined.
+    virtual vector<bool> payBatch(const vector<double>& amounts) {
+        vector<bool> results;
+        results.reserve(amounts.size());
+        for (double amount : amounts) {
+            try {
+                pay(amount);
+                results.push_back(true);
+            } catch (const exception&) {
+                results.push_back(false);
+            }
+        }
+        return results;
+    }
+    
     virtual ~PaymentStrategy() = default;
 };
 
@@ -87,6 +109,10 @@ public:
         total += price;
     }
     
+    double getTotal() const {
+        return total;
+    }
+    
     void checkout() {
         if (paymentStrategy) {
             paymentStrategy->pay(total);
@@ -94,6 +120,122 @@ public:
     }
 };
 
+// Fake provider for benchmarking - every call to the provider costs a fixed
+// round-trip latency, and each payment in a batch adds a small per-item cost
+class FakePaymentProvider : public PaymentStrategy {
+private:
+    chrono::microseconds callLatency;
+    chrono::microseconds perItemLatency;
+    double declineAbove;
+    int calls = 0;
+public:
+    FakePaymentProvider(chrono::microseconds callLatency,
+                        chrono::microseconds perItemLatency = chrono::microseconds(0),
+                        double declineAbove = 10000.0)
+        : callLatency(callLatency), perItemLatency(perItemLatency), declineAbove(declineAbove) {}
+    
+    // Same decline rule for single and batched payments
+    bool approves(double amount) const {
+        return amount <= declineAbove;
+    }
+    
+    void pay(double amount) override {
+        calls++;
+        this_thread::sleep_for(callLatency + perItemLatency);
+        if (!approves(amount)) {
+            throw runtime_error("Payment declined");
+        }
+    }
+    
+    vector<bool> payBatch(const vector<double>& amounts) override {
+        calls++;
+        this_thread::sleep_for(callLatency + perItemLatency * amounts.size());
+        vector<bool> results;
+        results.reserve(amounts.size());
+        for (double amount : amounts) {
+            results.push_back(approves(amount));
+        }
+        return results;
+    }
+    
+    int getCallCount() const { return calls; }
+};
+
+// Checkout batcher - queues carts per payment strategy and pays each group
+// with a single payBatch call, reporting a result for every cart
+struct CheckoutResult {
+    const ShoppingCart* cart;
+    double amount;
+    bool paid;
+};
+
+class CheckoutBatcher {
+private:
+    struct PendingCheckout {
+        size_t ticket;
+        const ShoppingCart* cart;
+    };
+    
+    size_t maxBatchSize;
+    size_t nextTicket = 0;
+    vector<PaymentStrategy*> strategyOrder;
+    unordered_map<PaymentStrategy*, vector<PendingCheckout>> pending;
+    vector<CheckoutResult> completed;
+    
+    void payGroup(PaymentStrategy* strategy, vector<PendingCheckout>& group) {
+        vector<double> amounts;
+        amounts.reserve(group.size());
+        for (const auto& entry : group) {
+            amounts.push_back(entry.cart->getTotal());
+        }
+        
+        vector<bool> paid = strategy->payBatch(amounts);
+        for (size_t i = 0; i < group.size(); i++) {
+            completed[group[i].ticket] = {group[i].cart, amounts[i], i < paid.size() && paid[i]};
+        }
+        group.clear();
+    }
+    
+public:
+    explicit CheckoutBatcher(size_t maxBatchSize = 256) : maxBatchSize(maxBatchSize) {}
+    
+    // Returns a ticket; the cart's result is at that index after flush()
+    size_t submit(const ShoppingCart& cart, PaymentStrategy& strategy) {
+        // A strategy is listed once per flush, even after an auto-flush empties its group
+        auto [entry, firstUse] = pending.try_emplace(&strategy);
+        if (firstUse) {
+            strategyOrder.push_back(&strategy);
+        }
+        auto& group = entry->second;
+        
+        size_t ticket = nextTicket++;
+        completed.push_back({&cart, cart.getTotal(), false});
+        group.push_back({ticket, &cart});
+        
+        if (group.size() >= maxBatchSize) {
+            payGroup(&strategy, group);
+        }
+        return ticket;
+    }
+    
+    // Pays everything still queued and hands back results in submission order
+    vector<CheckoutResult> flush() {
+        for (PaymentStrategy* strategy : strategyOrder) {
+            auto& group = pending[strategy];
+            if (!group.empty()) {
+                payGroup(strategy, group);
+            }
+        }
+        strategyOrder.clear();
+        pending.clear();
+        nextTicket = 0;
+        
+        vector<CheckoutResult> results;
+        results.swap(completed);
+        return results;
+    }
+};
+
 int main() {
     cout << "🎨 Design Patterns Example (C++)" << endl;
     cout << "=================================" << endl << endl;
@@ -124,6 +266,48 @@ int main() {
     cart.setPaymentStrategy(make_unique<PayPalPayment>());
     cart.checkout();
     
+    // Batching Demo - same strategies, far fewer provider round-trips
+    cout << endl << "📦 Checkout Batching - Fake Provider Throughput:" << endl;
+    const int cartCount = 200;
+    vector<ShoppingCart> carts(cartCount);
+    for (int i = 0; i < cartCount; i++) {
+        carts[i].addItem(10.0 + i);
+        carts[i].addItem(i % 50 == 0 ? 20000.0 : 5.0);
+    }
+    
+    FakePaymentProvider unbatchedProvider(chrono::microseconds(200), chrono::microseconds(2));
+    int unbatchedDeclined = 0;
+    auto start = chrono::steady_clock::now();
+    for (const auto& c : carts) {
+        try {
+            unbatchedProvider.pay(c.getTotal());
+        } catch (const runtime_error&) {
+            unbatchedDeclined++;
+        }
+    }
+    double unbatchedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    FakePaymentProvider batchedProvider(chrono::microseconds(200), chrono::microseconds(2));
+    CheckoutBatcher batcher(64);
+    start = chrono::steady_clock::now();
+    for (const auto& c : carts) {
+        batcher.submit(c, batchedProvider);
+    }
+    vector<CheckoutResult> results = batcher.flush();
+    double batchedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    int declined = 0;
+    for (const auto& r : results) {
+        if (!r.paid) declined++;
+    }
+    
+    cout << "   Unbatched: " << unbatchedProvider.getCallCount() << " provider calls, "
+         << static_cast<int>(cartCount / unbatchedSeconds) << " carts/sec" << endl;
+    cout << "   Batched:   " << batchedProvider.getCallCount() << " provider calls, "
+         << static_cast<int>(cartCount / batchedSeconds) << " carts/sec" << endl;
+    cout << "   Per-cart results: " << results.size() - declined << " paid, "
+         << declined << " declined (unbatched: " << unbatchedDeclined << " declined)" << endl;
+    
     cout << endl << "💡 Design Patterns Benefits:" << endl;
     cout << "   ✓ Observer: Loose coupling between publisher and subscribers" << endl;
     cout << "   ✓ Strategy: Easily switch algorithms at runtime" << endl;
@@ -5,35 +5,55 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <memory_resource>
+#include <chrono>
+#include <cstdio>
 using namespace std;
 
 // SOLID Principles working together in an e-commerce system
 
 // SRP - Single Responsibility
+// Products and orders allocate from a memory resource, so one request's whole
+// object graph can live in a single arena and be released at once
 class Product {
 private:
-    string id, name;
+    pmr::string id, name;
     double price;
 public:
-    Product(const string& id, const string& name, double price) 
-        : id(id), name(name), price(price) {}
+    using allocator_type = pmr::polymorphic_allocator<char>;
     
-    string getId() const { return id; }
-    string getName() const { return name; }
+    Product(string_view id, string_view name, double price, allocator_type alloc = {}) 
+        : id(id, alloc), name(name, alloc), price(price) {}
+    Product(const Product& other, allocator_type alloc = {})
+        : id(other.id, alloc), name(other.name, alloc), price(other.price) {}
+    Product(Product&& other, allocator_type alloc)
+        : id(move(other.id), alloc), name(move(other.name), alloc), price(other.price) {}
+    Product(Product&&) = default;
+    Product& operator=(const Product&) = default;
+    Product& operator=(Product&&) = default;
+    
+    string getId() const { return string(string_view(id)); }
+    string getName() const { return string(string_view(name)); }
     double getPrice() const { return price; }
 };
 
 class Order {
 private:
-    string id;
-    vector<Product> products;
+    pmr::string id;
+    pmr::vector<Product> products;
 public:
-    Order(const string& id) : id(id) {}
+    Order(string_view id, pmr::memory_resource* resource = pmr::get_default_resource())
+        : id(id, resource), products(resource) {}
     
     void addProduct(const Product& product) {
         products.push_back(product);
     }
     
+    void addProduct(Product&& product) {
+        products.push_back(move(product));
+    }
+    
     double getTotal() const {
         double total = 0;
         for (const auto& product : products) {
@@ -42,8 +62,8 @@ public:
         return total;
     }
     
-    const vector<Product>& getProducts() const { return products; }
-    string getId() const { return id; }
+    const pmr::vector<Product>& getProducts() const { return products; }
+    string getId() const { return string(string_view(id)); }
 };
 
 // OCP & DIP - Payment strategies (open for extension)
@@ -126,6 +146,43 @@ public:
     }
 };
 
+// Counts how often the wrapped resource is asked for memory
+class CountingMemoryResource : public pmr::memory_resource {
+private:
+    pmr::memory_resource* upstream;
+    size_t allocations = 0;
+    
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
+    }
+    
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        upstream->deallocate(pointer, bytes, alignment);
+    }
+    
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+    
+public:
+    explicit CountingMemoryResource(pmr::memory_resource* upstream = pmr::new_delete_resource())
+        : upstream(upstream) {}
+    
+    size_t getAllocations() const { return allocations; }
+};
+
+// One simulated request: build an order, total it, throw it away
+double handleOrderRequest(pmr::memory_resource* resource) {
+    Order order("ORD-REQUEST-000000001", resource);
+    char sku[32];
+    for (int i = 0; i < 50; i++) {
+        int length = snprintf(sku, sizeof(sku), "PRODUCT-SKU-%d", 100000 + i);
+        order.addProduct(Product(string_view(sku, length), "Catalog product description", 9.99 + i, resource));
+    }
+    return order.getTotal();
+}
+
 int main() {
     cout << "🏢 SOLID Principles in Practice (C++)" << endl;
     cout << "======================================" << endl << endl;
@@ -152,6 +209,32 @@ int main() {
     );
     service2.processOrder(order);
     
+    // Per-request arena - same Order code, allocations served from one buffer
+    cout << endl << "🧱 Per-request arena (1000 orders of 50 products):" << endl;
+    const int requests = 1000;
+    volatile double sink = 0;
+    
+    CountingMemoryResource heap;
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < requests; r++) {
+        sink = sink + handleOrderRequest(&heap);
+    }
+    double heapSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    CountingMemoryResource arenaUpstream;
+    vector<byte> arenaBuffer(32 * 1024);
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < requests; r++) {
+        pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size(), &arenaUpstream);
+        sink = sink + handleOrderRequest(&arena);
+    }
+    double arenaSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    cout << "   Heap:  " << heap.getAllocations() / requests << " allocator calls, "
+         << heapSeconds * 1e6 / requests << " us/request" << endl;
+    cout << "   Arena: " << arenaUpstream.getAllocations() / requests << " allocator calls, "
+         << arenaSeconds * 1e6 / requests << " us/request" << endl;
+    
     cout << endl << "💡 SOLID Principles Applied:" << endl;
     cout << "   🎯 SRP: Each class has one responsibility" << endl;
     cout << "   🔓 OCP: Can add new payment/notification methods" << endl;
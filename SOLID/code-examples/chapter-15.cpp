@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include <stdexcept>
+#include <exception>
+#include <utility>
 #include <numeric>
 #include <algorithm>
 #include <memory>
@@ -12,10 +14,356 @@
 #include <regex>
 #include <ctime>
 #include <iomanip>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <string_view>
+#include <deque>
+#include <cstdint>
+#include <memory_resource>
+#include <array>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <cstring>
+#include <filesystem>
+#include <charconv>
+#include <climits>
+#include <future>
+#include <condition_variable>
+#include <optional>
+#include <type_traits>
+#include <limits>
+#include <cctype>
+
+#ifdef _WIN32
+#include <io.h>
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Hand-written AVX2/AVX-512 kernels need GCC/Clang target attributes on x86;
+// every other build uses the scalar kernels
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CALCULATOR_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define CALCULATOR_X86_SIMD 0
+#endif
+
+// Allocation counting: every global operator new bumps a per-thread counter, so
+// tests and benchmarks can check how many heap allocations a piece of code makes
+// even while other tests run on other threads
+namespace AllocationCounter {
+    thread_local size_t allocations = 0;
+
+    template<typename Func>
+    size_t countAllocations(Func&& func) {
+        size_t before = allocations;
+        func();
+        return allocations - before;
+    }
+}
+
+void* operator new(std::size_t size) {
+    ++AllocationCounter::allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+// Kept out of line so GCC does not pair the inlined free() with operator new
+// and report a false -Wmismatched-new-delete
+[[gnu::noinline]] void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+// Over-aligned types (alignas(64) blocks and shards) come through these
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++AllocationCounter::allocations;
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (std::max<size_t>(size, 1) + align - 1) / align * align; // aligned_alloc needs a multiple
+#ifdef _WIN32
+    void* pointer = _aligned_malloc(rounded, align);
+#else
+    void* pointer = std::aligned_alloc(align, rounded);
+#endif
+    if (pointer != nullptr) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+[[gnu::noinline]] void operator delete(void* pointer, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
 
 // Example 1: Simple Calculator (Target for Testing)
+
+// Non-owning view of a contiguous array, standing in for C++20's std::span
+template<typename T>
+class ArrayView {
+private:
+    T* pointer;
+    size_t length;
+
+public:
+    ArrayView(T* pointer, size_t length) : pointer(pointer), length(length) {}
+
+    template<typename Container>
+    ArrayView(Container& container) : pointer(container.data()), length(container.size()) {}
+
+    T* data() const { return pointer; }
+    size_t size() const { return length; }
+    T& operator[](size_t index) const { return pointer[index]; }
+};
+
+enum class SimdLevel { SCALAR, AVX2, AVX512 };
+
+enum class BulkOperation { ADD, SUBTRACT, MULTIPLY, DIVIDE };
+
+inline const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512: return "AVX-512";
+        case SimdLevel::AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+// Best instruction set this CPU supports, detected once at run time
+inline SimdLevel detectSimdLevel() {
+#if CALCULATOR_X86_SIMD
+    static const SimdLevel detected = __builtin_cpu_supports("avx512f") ? SimdLevel::AVX512
+                                    : __builtin_cpu_supports("avx2") ? SimdLevel::AVX2
+                                    : SimdLevel::SCALAR;
+    return detected;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+// Expected-style result of a division that cannot throw: a zero divisor sets
+// the error and leaves the value NaN, so it also works as NaN-with-flag
+enum class CalculationError : uint8_t { NONE, DIVIDE_BY_ZERO };
+
+struct DivisionResult {
+    double value;
+    CalculationError error;
+
+    bool hasValue() const { return error == CalculationError::NONE; }
+    explicit operator bool() const { return hasValue(); }
+    double valueOr(double fallback) const { return hasValue() ? value : fallback; }
+};
+
+inline DivisionResult safeDivide(double a, double b) noexcept {
+    if (b == 0.0) {
+        return {std::numeric_limits<double>::quiet_NaN(), CalculationError::DIVIDE_BY_ZERO};
+    }
+    return {a / b, CalculationError::NONE};
+}
+
+// Element-wise kernels. Each returns how many divisors were zero; those
+// elements become NaN and their indices go to zeroDivisors when it is given.
+namespace BulkKernels {
+    inline size_t recordZeroDivisors(unsigned mask, size_t base, std::vector<size_t>* zeroDivisors) {
+        size_t count = 0;
+        for (size_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+            if (mask & 1u) {
+                ++count;
+                if (zeroDivisors) {
+                    zeroDivisors->push_back(base + lane);
+                }
+            }
+        }
+        return count;
+    }
+
+    template<BulkOperation OP>
+    size_t scalar(const double* a, const double* b, double* result, size_t begin, size_t end,
+                  std::vector<size_t>* zeroDivisors) {
+        size_t zeros = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if constexpr (OP == BulkOperation::ADD) {
+                result[i] = a[i] + b[i];
+            } else if constexpr (OP == BulkOperation::SUBTRACT) {
+                result[i] = a[i] - b[i];
+            } else if constexpr (OP == BulkOperation::MULTIPLY) {
+                result[i] = a[i] * b[i];
+            } else {
+                DivisionResult quotient = safeDivide(a[i], b[i]);
+                result[i] = quotient.value;
+                if (!quotient) {
+                    zeros += recordZeroDivisors(1u, i, zeroDivisors);
+                }
+            }
+        }
+        return zeros;
+    }
+
+    // Four independent accumulators let the additions overlap in the pipeline
+    inline double sumScalar(const double* values, size_t begin, size_t end) {
+        double sums[4] = {0.0, 0.0, 0.0, 0.0};
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            sums[0] += values[i];
+            sums[1] += values[i + 1];
+            sums[2] += values[i + 2];
+            sums[3] += values[i + 3];
+        }
+        for (; i < end; ++i) {
+            sums[0] += values[i];
+        }
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+#if CALCULATOR_X86_SIMD
+    template<BulkOperation OP>
+    __attribute__((target("avx2")))
+    size_t avx2(const double* a, const double* b, double* result, size_t count, std::vector<size_t>* zeroDivisors) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+        size_t zeros = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d x = _mm256_loadu_pd(a + i);
+            __m256d y = _mm256_loadu_pd(b + i);
+            __m256d value;
+            if constexpr (OP == BulkOperation::ADD) {
+                value = _mm256_add_pd(x, y);
+            } else if constexpr (OP == BulkOperation::SUBTRACT) {
+                value = _mm256_sub_pd(x, y);
+            } else if constexpr (OP == BulkOperation::MULTIPLY) {
+                value = _mm256_mul_pd(x, y);
+            } else {
+                __m256d isZero = _mm256_cmp_pd(y, zero, _CMP_EQ_OQ);
+                value = _mm256_blendv_pd(_mm256_div_pd(x, y), nan, isZero);
+                if (unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(isZero))) {
+                    zeros += recordZeroDivisors(mask, i, zeroDivisors);
+                }
+            }
+            _mm256_storeu_pd(result + i, value);
+        }
+        return zeros + scalar<OP>(a, b, result, i, count, zeroDivisors);
+    }
+
+    template<BulkOperation OP>
+    __attribute__((target("avx512f")))
+    size_t avx512(const double* a, const double* b, double* result, size_t count, std::vector<size_t>* zeroDivisors) {
+        const __m512d zero = _mm512_setzero_pd();
+        const __m512d nan = _mm512_set1_pd(std::numeric_limits<double>::quiet_NaN());
+        size_t zeros = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m512d x = _mm512_loadu_pd(a + i);
+            __m512d y = _mm512_loadu_pd(b + i);
+            __m512d value;
+            if constexpr (OP == BulkOperation::ADD) {
+                value = _mm512_add_pd(x, y);
+            } else if constexpr (OP == BulkOperation::SUBTRACT) {
+                value = _mm512_sub_pd(x, y);
+            } else if constexpr (OP == BulkOperation::MULTIPLY) {
+                value = _mm512_mul_pd(x, y);
+            } else {
+                __mmask8 isZero = _mm512_cmp_pd_mask(y, zero, _CMP_EQ_OQ);
+                value = _mm512_mask_blend_pd(isZero, _mm512_div_pd(x, y), nan);
+                if (isZero) {
+                    zeros += recordZeroDivisors(isZero, i, zeroDivisors);
+                }
+            }
+            _mm512_storeu_pd(result + i, value);
+        }
+        return zeros + scalar<OP>(a, b, result, i, count, zeroDivisors);
+    }
+
+    __attribute__((target("avx2")))
+    inline double sumAvx2(const double* values, size_t count) {
+        __m256d sums[4] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            sums[0] = _mm256_add_pd(sums[0], _mm256_loadu_pd(values + i));
+            sums[1] = _mm256_add_pd(sums[1], _mm256_loadu_pd(values + i + 4));
+            sums[2] = _mm256_add_pd(sums[2], _mm256_loadu_pd(values + i + 8));
+            sums[3] = _mm256_add_pd(sums[3], _mm256_loadu_pd(values + i + 12));
+        }
+        __m256d total = _mm256_add_pd(_mm256_add_pd(sums[0], sums[1]), _mm256_add_pd(sums[2], sums[3]));
+        double lanes[4];
+        _mm256_storeu_pd(lanes, total);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumScalar(values, i, count);
+    }
+
+    __attribute__((target("avx512f")))
+    inline double sumAvx512(const double* values, size_t count) {
+        __m512d sums[4] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            sums[0] = _mm512_add_pd(sums[0], _mm512_loadu_pd(values + i));
+            sums[1] = _mm512_add_pd(sums[1], _mm512_loadu_pd(values + i + 8));
+            sums[2] = _mm512_add_pd(sums[2], _mm512_loadu_pd(values + i + 16));
+            sums[3] = _mm512_add_pd(sums[3], _mm512_loadu_pd(values + i + 24));
+        }
+        __m512d total = _mm512_add_pd(_mm512_add_pd(sums[0], sums[1]), _mm512_add_pd(sums[2], sums[3]));
+        double lanes[8];
+        _mm512_storeu_pd(lanes, total);
+        return sumScalar(lanes, 0, 8) + sumScalar(values, i, count);
+    }
+#endif
+}
+
 class Calculator {
+private:
+    SimdLevel simdLevel;
+
+    template<BulkOperation OP>
+    size_t applyBulk(ArrayView<const double> a, ArrayView<const double> b, ArrayView<double> result,
+                     std::vector<size_t>* zeroDivisors) const {
+        if (a.size() != b.size() || a.size() != result.size()) {
+            throw std::invalid_argument("Bulk operands must have the same length");
+        }
+#if CALCULATOR_X86_SIMD
+        if (simdLevel == SimdLevel::AVX512) {
+            return BulkKernels::avx512<OP>(a.data(), b.data(), result.data(), a.size(), zeroDivisors);
+        }
+        if (simdLevel == SimdLevel::AVX2) {
+            return BulkKernels::avx2<OP>(a.data(), b.data(), result.data(), a.size(), zeroDivisors);
+        }
+#endif
+        return BulkKernels::scalar<OP>(a.data(), b.data(), result.data(), 0, a.size(), zeroDivisors);
+    }
+
 public:
+    // Requests above what the CPU supports fall back to the best it has
+    explicit Calculator(SimdLevel requested = detectSimdLevel())
+        : simdLevel(std::min(requested, detectSimdLevel())) {}
+
+    SimdLevel getSimdLevel() const {
+        return simdLevel;
+    }
+
     double add(double a, double b) {
         return a + b;
     }
@@ -35,8 +383,49 @@ public:
         return a / b;
     }
 
-    double calculateTotal(const std::vector<double>& numbers) {
-        return std::accumulate(numbers.begin(), numbers.end(), 0.0);
+    // Same as divide(), but reports a zero divisor in the result instead of
+    // throwing, for data where zero divisors are common
+    DivisionResult tryDivide(double a, double b) const noexcept {
+        return safeDivide(a, b);
+    }
+
+    // Bulk element-wise operations: result[i] = a[i] op b[i]. All three
+    // arrays must have the same length; result may alias a or b.
+    void add(ArrayView<const double> a, ArrayView<const double> b, ArrayView<double> result) const {
+        applyBulk<BulkOperation::ADD>(a, b, result, nullptr);
+    }
+
+    void subtract(ArrayView<const double> a, ArrayView<const double> b, ArrayView<double> result) const {
+        applyBulk<BulkOperation::SUBTRACT>(a, b, result, nullptr);
+    }
+
+    void multiply(ArrayView<const double> a, ArrayView<const double> b, ArrayView<double> result) const {
+        applyBulk<BulkOperation::MULTIPLY>(a, b, result, nullptr);
+    }
+
+    // Zero divisors do not throw: those elements become NaN, their indices
+    // are appended to zeroDivisors (if given) and their count is returned
+    size_t divide(ArrayView<const double> a, ArrayView<const double> b, ArrayView<double> result,
+                  std::vector<size_t>* zeroDivisors = nullptr) const {
+        return applyBulk<BulkOperation::DIVIDE>(a, b, result, zeroDivisors);
+    }
+
+    // Summed with several independent accumulators, so the result can differ
+    // from a strict left-to-right sum in the last bits
+    double calculateTotal(ArrayView<const double> numbers) const {
+#if CALCULATOR_X86_SIMD
+        if (simdLevel == SimdLevel::AVX512) {
+            return BulkKernels::sumAvx512(numbers.data(), numbers.size());
+        }
+        if (simdLevel == SimdLevel::AVX2) {
+            return BulkKernels::sumAvx2(numbers.data(), numbers.size());
+        }
+#endif
+        return BulkKernels::sumScalar(numbers.data(), 0, numbers.size());
+    }
+
+    double calculateTotal(const std::vector<double>& numbers) const {
+        return calculateTotal(ArrayView<const double>(numbers));
     }
 };
 
@@ -50,6 +439,10 @@ private:
 public:
     ShoppingCartItem(const std::string& name, double price, int quantity)
         : name(name), price(price), quantity(quantity) {
+        validate(name, price, quantity);
+    }
+
+    static void validate(std::string_view name, double price, int quantity) {
         if (name.empty()) {
             throw std::invalid_argument("Name cannot be empty");
         }
@@ -69,74 +462,342 @@ public:
 
 class ShoppingCart {
 private:
-    std::vector<std::unique_ptr<ShoppingCartItem>> items;
+    // Items are stored by value in one contiguous array; names are interned
+    // once per cart and referenced by id, so a line is just 24 bytes.
+    // Lines sharing a name are threaded into an intrusive list in insertion
+    // order, so removing one or moving one relinks neighbours in O(1).
+    // Every container allocates from the cart's memory resource, so a
+    // per-request arena can release the whole cart in one shot.
+    static constexpr uint32_t NO_LINE = UINT32_MAX;
+
+    struct CartLine {
+        uint32_t nameId;
+        int quantity;
+        double price;
+        uint32_t previousSameName = NO_LINE;
+        uint32_t nextSameName = NO_LINE;
+
+        int64_t getTotalCents() const { return std::llround(price * 100.0) * quantity; }
+    };
+
+    struct NameList {
+        uint32_t head = NO_LINE;
+        uint32_t tail = NO_LINE;
+    };
+
+    std::pmr::vector<CartLine> lines;
+    std::pmr::deque<std::pmr::string> names;                     // stable storage for interned names
+    std::pmr::unordered_map<std::string_view, uint32_t> nameIds; // views into names
+    std::pmr::vector<NameList> linesByNameId;                    // first and last line holding each name
+    int64_t totalCents = 0; // integer cents, so add/remove pairs cannot drift
+    int itemCount = 0;
+
+    // Either interns the name or throws with all three tables unchanged
+    uint32_t internName(const std::string& name) {
+        auto it = nameIds.find(name);
+        if (it != nameIds.end()) {
+            return it->second;
+        }
+
+        uint32_t id = static_cast<uint32_t>(names.size());
+        try {
+            names.emplace_back(std::string_view(name));
+            linesByNameId.emplace_back();
+            nameIds.emplace(names.back(), id);
+        } catch (...) {
+            if (linesByNameId.size() > id) {
+                linesByNameId.pop_back();
+            }
+            if (names.size() > id) {
+                names.pop_back();
+            }
+            throw;
+        }
+        return id;
+    }
+
+    void unlink(uint32_t slot) {
+        const CartLine& line = lines[slot];
+        NameList& list = linesByNameId[line.nameId];
+        if (line.previousSameName != NO_LINE) {
+            lines[line.previousSameName].nextSameName = line.nextSameName;
+        } else {
+            list.head = line.nextSameName;
+        }
+        if (line.nextSameName != NO_LINE) {
+            lines[line.nextSameName].previousSameName = line.previousSameName;
+        } else {
+            list.tail = line.previousSameName;
+        }
+    }
+
+    // Moves a line into another slot and points its neighbours at the new slot
+    void moveLine(uint32_t from, uint32_t to) {
+        const CartLine& line = lines[to] = lines[from];
+        NameList& list = linesByNameId[line.nameId];
+        (line.previousSameName != NO_LINE ? lines[line.previousSameName].nextSameName : list.head) = to;
+        (line.nextSameName != NO_LINE ? lines[line.nextSameName].previousSameName : list.tail) = to;
+    }
 
 public:
+    explicit ShoppingCart(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : lines(resource), names(resource), nameIds(resource), linesByNameId(resource) {}
+
+    // nameIds holds views into names, so a copy would point into the original
+    ShoppingCart(const ShoppingCart&) = delete;
+    ShoppingCart& operator=(const ShoppingCart&) = delete;
+
+    // Once a name has been seen, adding it again allocates nothing unless the
+    // line array has to grow. If an allocation throws, the cart is unchanged.
     void addItem(const std::string& name, double price, int quantity = 1) {
-        items.push_back(std::make_unique<ShoppingCartItem>(name, price, quantity));
+        ShoppingCartItem::validate(name, price, quantity);
+
+        lines.push_back({0, quantity, price});
+        uint32_t nameId;
+        try {
+            nameId = internName(name);
+        } catch (...) {
+            lines.pop_back();
+            throw;
+        }
+
+        uint32_t slot = static_cast<uint32_t>(lines.size() - 1);
+        CartLine& line = lines.back();
+        NameList& list = linesByNameId[nameId];
+        line.nameId = nameId;
+        line.previousSameName = list.tail;
+        (list.tail != NO_LINE ? lines[list.tail].nextSameName : list.head) = slot;
+        list.tail = slot;
+        totalCents += line.getTotalCents();
+        itemCount += quantity;
     }
 
     double getTotal() const {
-        double total = 0.0;
-        for (const auto& item : items) {
-            total += item->getTotalPrice();
-        }
-        return total;
+        return totalCents / 100.0;
     }
 
     int getItemCount() const {
-        int count = 0;
-        for (const auto& item : items) {
-            count += item->getQuantity();
-        }
-        return count;
+        return itemCount;
     }
 
     size_t getItemTypes() const {
-        return items.size();
+        return lines.size();
     }
 
+    // Keeps interned names so a refilled cart does not reallocate
     void clear() {
-        items.clear();
+        lines.clear();
+        std::fill(linesByNameId.begin(), linesByNameId.end(), NameList{});
+        totalCents = 0;
+        itemCount = 0;
     }
 
     bool hasItem(const std::string& name) const {
-        return std::any_of(items.begin(), items.end(),
-            [&name](const auto& item) {
-                return item->getName() == name;
-            });
+        auto it = nameIds.find(name);
+        return it != nameIds.end() && linesByNameId[it->second].head != NO_LINE;
     }
 
+    // Removes the earliest-added line with this name, which heads its list.
+    // The last line is moved into the freed slot (item order is not preserved)
     bool removeItem(const std::string& name) {
-        auto it = std::find_if(items.begin(), items.end(),
-            [&name](const auto& item) {
-                return item->getName() == name;
-            });
-        
-        if (it != items.end()) {
-            items.erase(it);
-            return true;
+        auto it = nameIds.find(name);
+        if (it == nameIds.end() || linesByNameId[it->second].head == NO_LINE) {
+            return false;
+        }
+
+        uint32_t slot = linesByNameId[it->second].head;
+        unlink(slot);
+        totalCents -= lines[slot].getTotalCents();
+        itemCount -= lines[slot].quantity;
+
+        uint32_t last = static_cast<uint32_t>(lines.size() - 1);
+        if (slot != last) {
+            moveLine(last, slot);
+        }
+        lines.pop_back();
+        return true;
+    }
+};
+
+// Example 2b: Shopping Cart shared between request threads
+// Totals are kept as atomic integer cents so getTotal() never takes a lock;
+// items go into per-thread shards so writers rarely contend on the same mutex.
+struct CartSnapshot {
+    std::vector<ShoppingCartItem> items;
+    long long totalCents = 0;
+    int itemCount = 0;
+
+    double getTotal() const { return totalCents / 100.0; }
+};
+
+class ConcurrentShoppingCart {
+private:
+    static const size_t SHARD_COUNT = 16;
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<ShoppingCartItem> items;
+        long long totalCents = 0;
+        int itemCount = 0;
+    };
+
+    Shard shards[SHARD_COUNT];
+    std::atomic<long long> totalCents{0};
+    std::atomic<int> itemCount{0};
+
+    static long long toCents(double amount) {
+        return std::llround(amount * 100.0);
+    }
+
+    Shard& shardForThisThread() {
+        size_t hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return shards[hash % SHARD_COUNT];
+    }
+
+public:
+    void addItem(const std::string& name, double price, int quantity = 1) {
+        ShoppingCartItem item(name, price, quantity);
+        long long cents = toCents(price) * quantity;
+
+        Shard& shard = shardForThisThread();
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.items.push_back(std::move(item));
+            shard.totalCents += cents;
+            shard.itemCount += quantity;
+        }
+
+        totalCents.fetch_add(cents, std::memory_order_relaxed);
+        itemCount.fetch_add(quantity, std::memory_order_relaxed);
+    }
+
+    // Lock-free running values; may lag a concurrent addItem by one item
+    double getTotal() const {
+        return totalCents.load(std::memory_order_relaxed) / 100.0;
+    }
+
+    int getItemCount() const {
+        return itemCount.load(std::memory_order_relaxed);
+    }
+
+    // Consistent view for checkout: holds every shard lock (in a fixed order)
+    // so items, total and count all describe the same moment
+    CartSnapshot snapshot() {
+        std::unique_lock<std::mutex> locks[SHARD_COUNT];
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            locks[i] = std::unique_lock<std::mutex>(shards[i].mutex);
         }
-        return false;
+
+        CartSnapshot result;
+        for (const auto& shard : shards) {
+            result.items.insert(result.items.end(), shard.items.begin(), shard.items.end());
+            result.totalCents += shard.totalCents;
+            result.itemCount += shard.itemCount;
+        }
+        return result;
+    }
+};
+
+// Baseline for comparison: the plain cart behind one mutex
+class MutexShoppingCart {
+private:
+    mutable std::mutex mutex;
+    ShoppingCart cart;
+
+public:
+    void addItem(const std::string& name, double price, int quantity = 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cart.addItem(name, price, quantity);
+    }
+
+    double getTotal() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cart.getTotal();
+    }
+
+    int getItemCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cart.getItemCount();
     }
 };
 
 // Example 3: TDD Password Validator
+namespace PasswordRules {
+    constexpr int MINIMUM_LENGTH = 8;
+}
+
+// Errors are recorded as bits and only turned into text when someone asks,
+// so validating (and rejecting) a password never touches the heap
+enum class ValidationError : uint8_t {
+    EMPTY,
+    TOO_SHORT,
+    MISSING_UPPERCASE,
+    MISSING_LOWERCASE,
+    MISSING_DIGIT,
+    MISSING_SPECIAL,
+    TOO_COMMON,
+    COUNT
+};
+
 class ValidationResult {
 private:
-    std::vector<std::string> errors;
+    uint8_t errorBits = 0;
+
+    static uint8_t bitFor(ValidationError error) {
+        return static_cast<uint8_t>(1u << static_cast<unsigned>(error));
+    }
 
 public:
+    static std::string describe(ValidationError error) {
+        switch (error) {
+            case ValidationError::EMPTY:
+                return "Password cannot be empty";
+            case ValidationError::TOO_SHORT:
+                return "Password must be at least " + std::to_string(PasswordRules::MINIMUM_LENGTH) + " characters long";
+            case ValidationError::MISSING_UPPERCASE:
+                return "Password must contain at least one uppercase letter";
+            case ValidationError::MISSING_LOWERCASE:
+                return "Password must contain at least one lowercase letter";
+            case ValidationError::MISSING_DIGIT:
+                return "Password must contain at least one digit";
+            case ValidationError::MISSING_SPECIAL:
+                return "Password must contain at least one special character (!@#$%^&*)";
+            case ValidationError::TOO_COMMON:
+                return "Password is too common. Please choose a more secure password";
+            default:
+                return "Unknown error";
+        }
+    }
+
     bool isValid() const {
-        return errors.empty();
+        return errorBits == 0;
+    }
+
+    bool hasError(ValidationError error) const {
+        return (errorBits & bitFor(error)) != 0;
     }
 
-    const std::vector<std::string>& getErrors() const {
+    size_t getErrorCount() const {
+        size_t count = 0;
+        for (uint8_t bits = errorBits; bits != 0; bits &= bits - 1) {
+            count++;
+        }
+        return count;
+    }
+
+    // Messages in rule order, rendered on demand
+    std::vector<std::string> getErrors() const {
+        std::vector<std::string> errors;
+        for (uint8_t e = 0; e < static_cast<uint8_t>(ValidationError::COUNT); ++e) {
+            if (hasError(static_cast<ValidationError>(e))) {
+                errors.push_back(describe(static_cast<ValidationError>(e)));
+            }
+        }
         return errors;
     }
 
-    void addError(const std::string& error) {
-        errors.push_back(error);
+    void addError(ValidationError error) {
+        errorBits |= bitFor(error);
     }
 
     std::string toString() const {
@@ -145,6 +806,7 @@ public:
         }
         
         std::string result = "Invalid: ";
+        std::vector<std::string> errors = getErrors();
         for (size_t i = 0; i < errors.size(); ++i) {
             if (i > 0) result += ", ";
             result += errors[i];
@@ -153,83 +815,536 @@ public:
     }
 };
 
-class PasswordValidator {
+// Read-only view of a whole file: memory-mapped where the platform allows,
+// otherwise read into memory. Mapping takes constant time and pages are read
+// on first touch, so a multi-gigabyte file opens instantly.
+class MappedFile {
 private:
-    static const int MINIMUM_LENGTH = 8;
-    static const std::vector<std::string> COMMON_PASSWORDS;
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<uint64_t> fallback; // 8-byte aligned copy when mapping is unavailable
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+#endif
 
-    bool hasMinimumLength(const std::string& password) const {
-        return password.length() >= MINIMUM_LENGTH;
+    void release() noexcept {
+        if (mapped) {
+#ifdef _WIN32
+            UnmapViewOfFile(bytes);
+            CloseHandle(mapping);
+            mapping = nullptr;
+#else
+            munmap(const_cast<char*>(bytes), length);
+#endif
+        }
+        bytes = nullptr;
+        length = 0;
+        mapped = false;
+        fallback.clear();
     }
 
-    bool hasUppercaseCharacter(const std::string& password) const {
-        return std::any_of(password.begin(), password.end(), [](char c) {
-            return std::isupper(c);
-        });
+    bool tryMap(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                if (bytes != nullptr) {
+                    length = static_cast<size_t>(size.QuadPart);
+                    mapped = true;
+                } else {
+                    CloseHandle(mapping);
+                    mapping = nullptr;
+                }
+            }
+        }
+        CloseHandle(file);
+#else
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(descriptor, &info) == 0 && info.st_size > 0) {
+            void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+            if (view != MAP_FAILED) {
+                bytes = static_cast<const char*>(view);
+                length = static_cast<size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        close(descriptor);
+#endif
+        return mapped;
     }
 
-    bool hasLowercaseCharacter(const std::string& password) const {
-        return std::any_of(password.begin(), password.end(), [](char c) {
-            return std::islower(c);
-        });
+    void readIntoMemory(const std::string& path) {
+        std::ifstream input(path, std::ios::binary | std::ios::ate);
+        if (!input) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        length = static_cast<size_t>(input.tellg());
+        input.seekg(0);
+        fallback.resize((length + 7) / 8);
+        input.read(reinterpret_cast<char*>(fallback.data()), static_cast<std::streamsize>(length));
+        if (!input) {
+            throw std::runtime_error("Cannot read file: " + path);
+        }
+        bytes = reinterpret_cast<const char*>(fallback.data());
     }
 
-    bool hasDigit(const std::string& password) const {
-        return std::any_of(password.begin(), password.end(), [](char c) {
-            return std::isdigit(c);
-        });
+public:
+    explicit MappedFile(const std::string& path) {
+        if (!tryMap(path)) {
+            readIntoMemory(path);
+        }
     }
 
-    bool hasSpecialCharacter(const std::string& password) const {
-        std::string specialChars = "!@#$%^&*";
-        return std::any_of(password.begin(), password.end(), [&specialChars](char c) {
-            return specialChars.find(c) != std::string::npos;
-        });
+    MappedFile(MappedFile&& other) noexcept
+        : bytes(other.bytes), length(other.length), mapped(other.mapped), fallback(std::move(other.fallback)) {
+#ifdef _WIN32
+        mapping = other.mapping;
+        other.mapping = nullptr;
+#endif
+        other.bytes = nullptr;
+        other.length = 0;
+        other.mapped = false;
     }
 
-    bool isCommonPassword(const std::string& password) const {
-        std::string lowerPassword = password;
-        std::transform(lowerPassword.begin(), lowerPassword.end(), lowerPassword.begin(), ::tolower);
-        
-        return std::any_of(COMMON_PASSWORDS.begin(), COMMON_PASSWORDS.end(),
-            [&lowerPassword](const std::string& common) {
-                return lowerPassword == common;
-            });
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            bytes = other.bytes;
+            length = other.length;
+            mapped = other.mapped;
+            fallback = std::move(other.fallback);
+#ifdef _WIN32
+            mapping = other.mapping;
+            other.mapping = nullptr;
+#endif
+            other.bytes = nullptr;
+            other.length = 0;
+            other.mapped = false;
+        }
+        return *this;
     }
 
-public:
-    ValidationResult validatePassword(const std::string& password) const {
-        ValidationResult result;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
 
-        if (password.empty()) {
-            result.addError("Password cannot be empty");
-            return result;
-        }
+    ~MappedFile() {
+        release();
+    }
 
-        if (!hasMinimumLength(password)) {
-            result.addError("Password must be at least " + std::to_string(MINIMUM_LENGTH) + " characters long");
-        }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+};
 
-        if (!hasUppercaseCharacter(password)) {
-            result.addError("Password must contain at least one uppercase letter");
-        }
+// Example 3b: Breached-password blocklist
+// A blocked Bloom filter rejects almost every clean password after touching a
+// single 64-byte block. The filter is its own file, about 1.5 bytes per
+// entry, and can be shipped alone; it then accepts a clean password about
+// once in a few hundred. An optional second file of sorted 64-bit password
+// hashes confirms filter hits exactly by binary search. Both files are
+// memory-mapped, so loading is constant time whatever the list size.
+class BreachedPasswordIndex {
+private:
+    static const uint64_t FILTER_MAGIC = 0x58495042; // "BPIX"
+    static const uint64_t HASH_MAGIC = 0x58485042;   // "BPHX"
+    static const uint64_t FILE_VERSION = 2;
+    static const size_t FILTER_HEADER_WORDS = 8;     // 64 bytes, so mapped blocks stay cache-line aligned
+    static const size_t HASH_HEADER_WORDS = 4;
+    static const int BITS_PER_ENTRY = 12;
+    static const int PROBES = 6;
 
-        if (!hasLowercaseCharacter(password)) {
-            result.addError("Password must contain at least one lowercase letter");
-        }
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
 
-        if (!hasDigit(password)) {
-            result.addError("Password must contain at least one digit");
-        }
+    // Storage for an index built in memory, or the mapped files of a loaded one
+    std::vector<Block> ownedBlocks;
+    std::vector<uint64_t> ownedHashes;
+    std::optional<MappedFile> filterFile;
+    std::optional<MappedFile> hashFile;
 
-        if (!hasSpecialCharacter(password)) {
-            result.addError("Password must contain at least one special character (!@#$%^&*)");
-        }
+    // Views into that storage; hashes is null when there is no confirmation file
+    const uint64_t* filterWords = nullptr;
+    size_t blockCount = 0;
+    size_t entryCount = 0;
+    const uint64_t* hashes = nullptr;
+    size_t hashCount = 0;
 
-        if (isCommonPassword(password)) {
-            result.addError("Password is too common. Please choose a more secure password");
+    // FNV-1a with a murmur finalizer: stable across runs, so it can go on disk
+    static uint64_t hashPassword(std::string_view password) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : password) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
         }
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
 
+    static size_t blockIndex(uint64_t hash, size_t blocks) {
+        return static_cast<size_t>(((hash >> 32) * blocks) >> 32);
+    }
+
+    // Probe bits within the block come from the low half of the hash
+    template<typename Visit>
+    static bool forEachProbe(uint64_t hash, Visit&& visit) {
+        uint32_t step = static_cast<uint32_t>(hash) | 1;
+        uint32_t bit = static_cast<uint32_t>(hash >> 16);
+        for (int i = 0; i < PROBES; ++i) {
+            if (!visit((bit >> 6) & 7, uint64_t(1) << (bit & 63))) {
+                return false;
+            }
+            bit += step;
+        }
+        return true;
+    }
+
+    bool mayContain(uint64_t hash) const {
+        const uint64_t* block = filterWords + 8 * blockIndex(hash, blockCount);
+        return forEachProbe(hash, [block](uint32_t word, uint64_t mask) {
+            return (block[word] & mask) != 0;
+        });
+    }
+
+    // Checks a mapped file's header and length; returns the header words
+    template<size_t HeaderWords>
+    static std::array<uint64_t, HeaderWords> readHeader(const MappedFile& file, uint64_t magic,
+                                                        const std::string& path) {
+        std::array<uint64_t, HeaderWords> header{};
+        if (file.size() < sizeof(header)) {
+            throw std::runtime_error("Not a password index file: " + path);
+        }
+        std::memcpy(header.data(), file.data(), sizeof(header));
+        if (header[0] != magic || header[1] != FILE_VERSION) {
+            throw std::runtime_error("Not a password index file: " + path);
+        }
+        return header;
+    }
+
+    template<typename T>
+    static void writeFile(const std::string& path, const uint64_t* header, size_t headerWords,
+                          const T* items, size_t count) {
+        std::ofstream output(path, std::ios::binary);
+        output.write(reinterpret_cast<const char*>(header), static_cast<std::streamsize>(headerWords * sizeof(uint64_t)));
+        output.write(reinterpret_cast<const char*>(items), static_cast<std::streamsize>(count * sizeof(T)));
+        if (!output) {
+            throw std::runtime_error("Cannot write password index: " + path);
+        }
+    }
+
+public:
+    BreachedPasswordIndex() = default;
+    BreachedPasswordIndex(BreachedPasswordIndex&&) = default;
+    BreachedPasswordIndex& operator=(BreachedPasswordIndex&&) = default;
+    // The views point into this object's own storage
+    BreachedPasswordIndex(const BreachedPasswordIndex&) = delete;
+    BreachedPasswordIndex& operator=(const BreachedPasswordIndex&) = delete;
+
+    // Builds from raw hashes so huge lists never need their strings in memory
+    static BreachedPasswordIndex fromHashes(std::vector<uint64_t> hashes) {
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+        BreachedPasswordIndex index;
+        size_t blocks = std::max<size_t>((hashes.size() * BITS_PER_ENTRY + 511) / 512, 1);
+        index.ownedBlocks.assign(blocks, Block{});
+        for (uint64_t hash : hashes) {
+            Block& block = index.ownedBlocks[blockIndex(hash, blocks)];
+            forEachProbe(hash, [&block](uint32_t word, uint64_t mask) {
+                block.words[word] |= mask;
+                return true;
+            });
+        }
+        index.ownedHashes = std::move(hashes);
+        index.filterWords = reinterpret_cast<const uint64_t*>(index.ownedBlocks.data());
+        index.blockCount = blocks;
+        index.entryCount = index.ownedHashes.size();
+        index.hashes = index.ownedHashes.data();
+        index.hashCount = index.ownedHashes.size();
+        return index;
+    }
+
+    static BreachedPasswordIndex fromPasswords(const std::vector<std::string>& passwords) {
+        std::vector<uint64_t> hashes;
+        hashes.reserve(passwords.size());
+        for (const auto& password : passwords) {
+            hashes.push_back(hashPassword(password));
+        }
+        return fromHashes(std::move(hashes));
+    }
+
+    // Index builder: one password per line, as breach dumps are usually published
+    static BreachedPasswordIndex fromTextFile(const std::string& path) {
+        std::ifstream input(path);
+        if (!input) {
+            throw std::runtime_error("Cannot open password list: " + path);
+        }
+
+        std::vector<uint64_t> hashes;
+        std::string line;
+        while (std::getline(input, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                hashes.push_back(hashPassword(line));
+            }
+        }
+        return fromHashes(std::move(hashes));
+    }
+
+    // Writes the filter, and the exact hashes too when hashPath is given
+    void save(const std::string& filterPath, const std::string& hashPath = "") const {
+        uint64_t filterHeader[FILTER_HEADER_WORDS] = {FILTER_MAGIC, FILE_VERSION, blockCount, entryCount};
+        writeFile(filterPath, filterHeader, FILTER_HEADER_WORDS, filterWords, blockCount * 8);
+
+        if (!hashPath.empty()) {
+            if (hashes == nullptr) {
+                throw std::runtime_error("Index has no exact hashes to save: " + hashPath);
+            }
+            uint64_t hashHeader[HASH_HEADER_WORDS] = {HASH_MAGIC, FILE_VERSION, hashCount, entryCount};
+            writeFile(hashPath, hashHeader, HASH_HEADER_WORDS, hashes, hashCount);
+        }
+    }
+
+    // Maps the filter and, if hashPath is given, the exact hashes. Only the
+    // headers are read, and every count is checked against the file length,
+    // so a corrupt header cannot point lookups past the end of the mapping.
+    static BreachedPasswordIndex load(const std::string& filterPath, const std::string& hashPath = "") {
+        BreachedPasswordIndex index;
+        const MappedFile& filter = index.filterFile.emplace(filterPath);
+        auto filterHeader = readHeader<FILTER_HEADER_WORDS>(filter, FILTER_MAGIC, filterPath);
+        uint64_t blockBytes = filter.size() - sizeof(filterHeader);
+        if (filterHeader[2] == 0 || filterHeader[2] != blockBytes / sizeof(Block) || blockBytes % sizeof(Block) != 0) {
+            throw std::runtime_error("Password index size does not match its header: " + filterPath);
+        }
+        index.filterWords = reinterpret_cast<const uint64_t*>(filter.data() + sizeof(filterHeader));
+        index.blockCount = static_cast<size_t>(filterHeader[2]);
+        index.entryCount = static_cast<size_t>(filterHeader[3]);
+
+        if (!hashPath.empty()) {
+            const MappedFile& hashData = index.hashFile.emplace(hashPath);
+            auto hashHeader = readHeader<HASH_HEADER_WORDS>(hashData, HASH_MAGIC, hashPath);
+            uint64_t hashBytes = hashData.size() - sizeof(hashHeader);
+            if (hashHeader[2] != hashBytes / sizeof(uint64_t) || hashBytes % sizeof(uint64_t) != 0) {
+                throw std::runtime_error("Password index size does not match its header: " + hashPath);
+            }
+            if (hashHeader[3] != filterHeader[3]) {
+                throw std::runtime_error("Password hash file does not belong to this filter: " + hashPath);
+            }
+            index.hashes = reinterpret_cast<const uint64_t*>(hashData.data() + sizeof(hashHeader));
+            index.hashCount = static_cast<size_t>(hashHeader[2]);
+        }
+        return index;
+    }
+
+    // Without the hash file a filter hit is reported as breached, so a small
+    // fraction of clean passwords is rejected too
+    bool contains(std::string_view password) const {
+        uint64_t hash = hashPassword(password);
+        if (!mayContain(hash)) {
+            return false;
+        }
+        return hashes == nullptr || std::binary_search(hashes, hashes + hashCount, hash);
+    }
+
+    size_t size() const {
+        return entryCount;
+    }
+
+    bool hasExactConfirmation() const {
+        return hashes != nullptr;
+    }
+
+    bool isMemoryMapped() const {
+        return filterFile.has_value() && filterFile->isMapped();
+    }
+};
+
+// Character-class bits; one table lookup per byte classifies a character
+namespace CharClass {
+    constexpr uint8_t UPPERCASE = 1 << 0;
+    constexpr uint8_t LOWERCASE = 1 << 1;
+    constexpr uint8_t DIGIT = 1 << 2;
+    constexpr uint8_t SPECIAL = 1 << 3;
+    constexpr uint8_t ALL = UPPERCASE | LOWERCASE | DIGIT | SPECIAL;
+
+    constexpr std::array<uint8_t, 256> buildTable() {
+        std::array<uint8_t, 256> table{};
+        for (int c = 'A'; c <= 'Z'; ++c) table[c] = UPPERCASE;
+        for (int c = 'a'; c <= 'z'; ++c) table[c] = LOWERCASE;
+        for (int c = '0'; c <= '9'; ++c) table[c] = DIGIT;
+        for (char c : {'!', '@', '#', '$', '%', '^', '&', '*'}) table[static_cast<unsigned char>(c)] = SPECIAL;
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> TABLE = buildTable();
+}
+
+class PasswordValidator {
+private:
+    static const int MINIMUM_LENGTH = PasswordRules::MINIMUM_LENGTH;
+    static const std::vector<std::string> COMMON_PASSWORDS;
+
+    std::shared_ptr<const BreachedPasswordIndex> breachedPasswords;
+
+    // Single pass over the password; stops as soon as every class has been seen
+    static uint8_t classifyCharacters(const std::string& password) {
+        uint8_t classes = 0;
+        for (unsigned char c : password) {
+            classes |= CharClass::TABLE[c];
+            if (classes == CharClass::ALL) {
+                break;
+            }
+        }
+        return classes;
+    }
+
+    static char toLowerAscii(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // Case-insensitive match without building a lowercased copy
+    static bool matchesCommonPassword(const std::string& password) {
+        return std::any_of(COMMON_PASSWORDS.begin(), COMMON_PASSWORDS.end(),
+            [&password](const std::string& common) {
+                return common.size() == password.size() &&
+                    std::equal(common.begin(), common.end(), password.begin(),
+                        [](char a, char b) { return a == toLowerAscii(b); });
+            });
+    }
+
+    bool isBreachedPassword(const std::string& password) const {
+        return breachedPasswords && breachedPasswords->contains(password);
+    }
+
+    bool hasMinimumLength(const std::string& password) const {
+        return password.length() >= MINIMUM_LENGTH;
+    }
+
+    bool hasUppercaseCharacter(const std::string& password) const {
+        return std::any_of(password.begin(), password.end(), [](char c) {
+            return std::isupper(c);
+        });
+    }
+
+    bool hasLowercaseCharacter(const std::string& password) const {
+        return std::any_of(password.begin(), password.end(), [](char c) {
+            return std::islower(c);
+        });
+    }
+
+    bool hasDigit(const std::string& password) const {
+        return std::any_of(password.begin(), password.end(), [](char c) {
+            return std::isdigit(c);
+        });
+    }
+
+    bool hasSpecialCharacter(const std::string& password) const {
+        std::string specialChars = "!@#$%^&*";
+        return std::any_of(password.begin(), password.end(), [&specialChars](char c) {
+            return specialChars.find(c) != std::string::npos;
+        });
+    }
+
+    bool isCommonPassword(const std::string& password) const {
+        std::string lowerPassword = password;
+        std::transform(lowerPassword.begin(), lowerPassword.end(), lowerPassword.begin(), ::tolower);
+        
+        return std::any_of(COMMON_PASSWORDS.begin(), COMMON_PASSWORDS.end(),
+            [&lowerPassword](const std::string& common) {
+                return lowerPassword == common;
+            });
+    }
+
+    void addErrors(ValidationResult& result, const std::string& password, uint8_t classes, bool isCommon) const {
+        if (!hasMinimumLength(password)) {
+            result.addError(ValidationError::TOO_SHORT);
+        }
+
+        if (!(classes & CharClass::UPPERCASE)) {
+            result.addError(ValidationError::MISSING_UPPERCASE);
+        }
+
+        if (!(classes & CharClass::LOWERCASE)) {
+            result.addError(ValidationError::MISSING_LOWERCASE);
+        }
+
+        if (!(classes & CharClass::DIGIT)) {
+            result.addError(ValidationError::MISSING_DIGIT);
+        }
+
+        if (!(classes & CharClass::SPECIAL)) {
+            result.addError(ValidationError::MISSING_SPECIAL);
+        }
+
+        if (isCommon) {
+            result.addError(ValidationError::TOO_COMMON);
+        }
+    }
+
+public:
+    // Passwords found in the index are rejected as too common
+    void setBreachedPasswordIndex(std::shared_ptr<const BreachedPasswordIndex> index) {
+        breachedPasswords = std::move(index);
+    }
+
+    ValidationResult validatePassword(const std::string& password) const {
+        ValidationResult result;
+
+        if (password.empty()) {
+            result.addError(ValidationError::EMPTY);
+            return result;
+        }
+
+        bool isCommon = matchesCommonPassword(password) || isBreachedPassword(password);
+        addErrors(result, password, classifyCharacters(password), isCommon);
+        return result;
+    }
+
+    // Validates many passwords in one call, results in input order
+    std::vector<ValidationResult> validatePasswords(const std::vector<std::string>& passwords) const {
+        std::vector<ValidationResult> results;
+        results.reserve(passwords.size());
+        for (const auto& password : passwords) {
+            results.push_back(validatePassword(password));
+        }
+        return results;
+    }
+
+    // Original one-pass-per-rule implementation, kept as the reference the
+    // table-driven path is tested and benchmarked against
+    ValidationResult validatePasswordReference(const std::string& password) const {
+        ValidationResult result;
+
+        if (password.empty()) {
+            result.addError(ValidationError::EMPTY);
+            return result;
+        }
+
+        uint8_t classes = 0;
+        if (hasUppercaseCharacter(password)) classes |= CharClass::UPPERCASE;
+        if (hasLowercaseCharacter(password)) classes |= CharClass::LOWERCASE;
+        if (hasDigit(password)) classes |= CharClass::DIGIT;
+        if (hasSpecialCharacter(password)) classes |= CharClass::SPECIAL;
+
+        addErrors(result, password, classes, isCommonPassword(password) || isBreachedPassword(password));
         return result;
     }
 };
@@ -244,6 +1359,119 @@ enum class TransactionType {
     WITHDRAWAL
 };
 
+// Statement row formatting without stringstreams
+// Converting a timestamp to local time is the slow part of a statement row,
+// so the renderer remembers the local date and midnight of the last day it
+// saw; rows from the same day only need H:M:S arithmetic. Days that contain
+// a DST switch are not cached. Each renderer is used by one thread; the
+// conversion itself uses the reentrant localtime_r/localtime_s.
+class StatementRenderer {
+private:
+    std::time_t dayStart = 0;
+    std::time_t dayEnd = 0;   // empty window until the first refresh
+    char date[10] = {};
+
+    static std::tm toLocalTime(std::time_t timestamp) {
+        std::tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &timestamp);
+#else
+        localtime_r(&timestamp, &local);
+#endif
+        return local;
+    }
+
+    static char* writeDigits(char* out, int value, int width) {
+        for (int i = width - 1; i >= 0; --i) {
+            out[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return out + width;
+    }
+
+    static char* writeDateTime(char* out, const std::tm& local) {
+        out = writeDigits(out, local.tm_year + 1900, 4);
+        *out++ = '-';
+        out = writeDigits(out, local.tm_mon + 1, 2);
+        *out++ = '-';
+        return writeDigits(out, local.tm_mday, 2);
+    }
+
+    void refreshDay(std::time_t timestamp, const std::tm& local) {
+        std::time_t midnight = timestamp - (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec);
+        std::tm atMidnight = toLocalTime(midnight);
+        std::tm beforeNextMidnight = toLocalTime(midnight + 86399);
+        bool plainDay = atMidnight.tm_hour == 0 && atMidnight.tm_min == 0 && atMidnight.tm_sec == 0 &&
+                        beforeNextMidnight.tm_hour == 23 && beforeNextMidnight.tm_min == 59 &&
+                        beforeNextMidnight.tm_mday == local.tm_mday;
+
+        writeDateTime(date, local);
+        dayStart = midnight;
+        dayEnd = plainDay ? midnight + 86400 : midnight;
+    }
+
+public:
+    // Appends "YYYY-MM-DD HH:MM:SS"
+    void appendTimestamp(std::string& out, std::time_t timestamp) {
+        char text[19];
+        if (timestamp >= dayStart && timestamp < dayEnd) {
+            int secondsIntoDay = static_cast<int>(timestamp - dayStart);
+            std::memcpy(text, date, sizeof(date));
+            text[10] = ' ';
+            writeDigits(text + 11, secondsIntoDay / 3600, 2);
+            text[13] = ':';
+            writeDigits(text + 14, secondsIntoDay / 60 % 60, 2);
+            text[16] = ':';
+            writeDigits(text + 17, secondsIntoDay % 60, 2);
+        } else {
+            std::tm local = toLocalTime(timestamp);
+            refreshDay(timestamp, local);
+            writeDateTime(text, local);
+            text[10] = ' ';
+            writeDigits(text + 11, local.tm_hour, 2);
+            text[13] = ':';
+            writeDigits(text + 14, local.tm_min, 2);
+            text[16] = ':';
+            writeDigits(text + 17, local.tm_sec, 2);
+        }
+        out.append(text, sizeof(text));
+    }
+
+    // Appends "123.45" from integer cents
+    static void appendAmount(std::string& out, int64_t cents) {
+        char text[24];
+        char* end = text;
+        // Negate in unsigned arithmetic so INT64_MIN does not overflow
+        uint64_t magnitude = static_cast<uint64_t>(cents);
+        if (cents < 0) {
+            *end++ = '-';
+            magnitude = 0 - magnitude;
+        }
+        end = std::to_chars(end, text + sizeof(text), magnitude / 100).ptr;
+        *end++ = '.';
+        end = writeDigits(end, static_cast<int>(magnitude % 100), 2);
+        out.append(text, end);
+    }
+
+    // Appends a double amount exactly as std::fixed << std::setprecision(2)
+    // would, so 0.125 still renders as "0.12"
+    static void appendAmount(std::string& out, double amount) {
+        char text[512];
+        auto result = std::to_chars(text, text + sizeof(text), amount, std::chars_format::fixed, 2);
+        out.append(text, result.ptr);
+    }
+
+    // Same layout as Transaction::toString; Amount is int64_t cents or a double
+    template<typename Amount>
+    void appendRow(std::string& out, TransactionType type, Amount amount, std::time_t timestamp, std::string_view description) {
+        appendTimestamp(out, timestamp);
+        out += type == TransactionType::DEPOSIT ? " - Deposit: $" : " - Withdrawal: $";
+        appendAmount(out, amount);
+        out += " - ";
+        out += description;
+    }
+};
+
 struct Transaction {
     TransactionType type;
     double amount;
@@ -255,274 +1483,3830 @@ struct Transaction {
         timestamp = std::time(nullptr);
     }
 
-    std::string toString() const {
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&timestamp), "%Y-%m-%d %H:%M:%S");
-        ss << " - " << (type == TransactionType::DEPOSIT ? "Deposit" : "Withdrawal");
-        ss << ": $" << std::fixed << std::setprecision(2) << amount;
-        ss << " - " << description;
-        return ss.str();
+    Transaction(TransactionType type, double amount, const std::string& description, std::time_t timestamp)
+        : type(type), amount(amount), description(description), timestamp(timestamp) {}
+
+    std::string toString() const {
+        thread_local StatementRenderer renderer;
+        std::string row;
+        renderer.appendRow(row, type, amount, timestamp, description);
+        return row;
+    }
+
+    // Original stringstream formatting, kept as the reference for tests and benchmarks
+    std::string toStringReference() const {
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&timestamp), "%Y-%m-%d %H:%M:%S");
+        ss << " - " << (type == TransactionType::DEPOSIT ? "Deposit" : "Withdrawal");
+        ss << ": $" << std::fixed << std::setprecision(2) << amount;
+        ss << " - " << description;
+        return ss.str();
+    }
+};
+
+// Totals for one time window, split by transaction type
+struct TransactionSummary {
+    int64_t depositCents = 0;
+    int64_t withdrawalCents = 0;
+    size_t depositCount = 0;
+    size_t withdrawalCount = 0;
+};
+
+// Columnar, append-only transaction ledger
+// Each column lives in chunks that double in size (16, 32, 64, ... rows), so
+// appending never moves or copies existing history and a short ledger stays
+// small. Amounts are integer cents, the type is one bit per row and
+// descriptions are interned, since statements repeat a handful of them.
+// Rows must be appended in timestamp order, and each row stores running
+// prefix sums, so any time window is found by binary search and summed with
+// two subtractions. Because rows are never inserted, plain prefix sums are
+// enough and no Fenwick tree is needed.
+class TransactionLedger {
+private:
+    static const size_t FIRST_CHUNK_BITS = 4;
+    static const size_t FIRST_CHUNK_SIZE = size_t(1) << FIRST_CHUNK_BITS;
+
+    struct Chunk {
+        explicit Chunk(size_t capacity)
+            : amountCents(capacity), timestamps(capacity), descriptionIds(capacity),
+              withdrawalBits((capacity + 63) / 64), depositCentsThrough(capacity),
+              withdrawalCentsThrough(capacity), withdrawalCountThrough(capacity) {}
+
+        std::vector<int64_t> amountCents;
+        std::vector<std::time_t> timestamps;
+        std::vector<uint32_t> descriptionIds;
+        std::vector<uint64_t> withdrawalBits;
+        // Inclusive running totals up to and including each row
+        std::vector<int64_t> depositCentsThrough;
+        std::vector<int64_t> withdrawalCentsThrough;
+        std::vector<uint64_t> withdrawalCountThrough;
+    };
+
+    // Chunk k holds FIRST_CHUNK_SIZE << k rows and starts at row
+    // FIRST_CHUNK_SIZE * (2^k - 1), so the chunk is the highest set bit of
+    // index + FIRST_CHUNK_SIZE and the slot is the bits below it
+    struct Location {
+        size_t chunk;
+        size_t slot;
+    };
+
+    static size_t highestBit(size_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(value)));
+#else
+        size_t bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    static Location locate(size_t index) {
+        size_t position = index + FIRST_CHUNK_SIZE;
+        size_t top = highestBit(position);
+        return {top - FIRST_CHUNK_BITS, position - (size_t(1) << top)};
+    }
+
+    uint32_t descriptionIdAt(size_t index) const {
+        Location row = locate(index);
+        return chunks[row.chunk]->descriptionIds[row.slot];
+    }
+
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    size_t count = 0;
+    std::deque<std::string> descriptions;                               // stable storage
+    std::unordered_map<std::string_view, uint32_t> descriptionIds;      // views into descriptions
+    int64_t depositCents = 0;
+    int64_t withdrawalCents = 0;
+    uint64_t withdrawalCount = 0;
+
+    uint32_t internDescription(std::string_view description) {
+        auto it = descriptionIds.find(description);
+        if (it != descriptionIds.end()) {
+            return it->second;
+        }
+
+        uint32_t id = static_cast<uint32_t>(descriptions.size());
+        descriptions.emplace_back(description);
+        descriptionIds.emplace(descriptions.back(), id);
+        return id;
+    }
+
+
+public:
+    TransactionLedger() = default;
+    TransactionLedger(TransactionLedger&&) = default;
+    TransactionLedger& operator=(TransactionLedger&&) = default;
+
+    // Rows must arrive in timestamp order, which keeps the ledger append-only.
+    // An earlier timestamp throws std::invalid_argument and changes nothing;
+    // callers stamping rows from the wall clock use nextTimestamp().
+    void append(TransactionType type, int64_t amountCents, std::string_view description, std::time_t timestamp) {
+        if (count > 0 && timestamp < timestampAt(count - 1)) {
+            throw std::invalid_argument("Ledger rows must be appended in timestamp order");
+        }
+
+        uint32_t descriptionId = internDescription(description);
+        size_t slot = locate(count).slot;
+        if (slot == 0) {
+            chunks.push_back(std::make_unique<Chunk>(FIRST_CHUNK_SIZE << chunks.size()));
+        }
+
+        Chunk& chunk = *chunks.back();
+        chunk.amountCents[slot] = amountCents;
+        chunk.timestamps[slot] = timestamp;
+        chunk.descriptionIds[slot] = descriptionId;
+        if (type == TransactionType::WITHDRAWAL) {
+            chunk.withdrawalBits[slot / 64] |= uint64_t(1) << (slot % 64);
+            withdrawalCents += amountCents;
+            withdrawalCount++;
+        } else {
+            depositCents += amountCents;
+        }
+        chunk.depositCentsThrough[slot] = depositCents;
+        chunk.withdrawalCentsThrough[slot] = withdrawalCents;
+        chunk.withdrawalCountThrough[slot] = withdrawalCount;
+        count++;
+    }
+
+    // timestamp, or the last row's timestamp if that is later, so the result
+    // can always be appended. A clock that steps back is held at the last row.
+    std::time_t orderedTimestamp(std::time_t timestamp) const {
+        return count > 0 ? std::max(timestamp, timestampAt(count - 1)) : timestamp;
+    }
+
+    std::time_t nextTimestamp() const {
+        return orderedTimestamp(std::time(nullptr));
+    }
+
+    // First row with timestamp >= time
+    size_t lowerBound(std::time_t time) const {
+        size_t low = 0;
+        size_t high = count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (timestampAt(middle) < time) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    // Totals of rows [first, last) from the prefix columns
+    TransactionSummary summarizeRows(size_t first, size_t last) const {
+        TransactionSummary summary;
+        if (first >= last) {
+            return summary;
+        }
+
+        Location endRow = locate(last - 1);
+        const Chunk& end = *chunks[endRow.chunk];
+        size_t endSlot = endRow.slot;
+        summary.depositCents = end.depositCentsThrough[endSlot];
+        summary.withdrawalCents = end.withdrawalCentsThrough[endSlot];
+        uint64_t withdrawals = end.withdrawalCountThrough[endSlot];
+
+        if (first > 0) {
+            Location beforeRow = locate(first - 1);
+            const Chunk& before = *chunks[beforeRow.chunk];
+            size_t beforeSlot = beforeRow.slot;
+            summary.depositCents -= before.depositCentsThrough[beforeSlot];
+            summary.withdrawalCents -= before.withdrawalCentsThrough[beforeSlot];
+            withdrawals -= before.withdrawalCountThrough[beforeSlot];
+        }
+
+        summary.withdrawalCount = static_cast<size_t>(withdrawals);
+        summary.depositCount = (last - first) - summary.withdrawalCount;
+        return summary;
+    }
+
+    // O(log n) totals for transactions in [from, to)
+    TransactionSummary summarize(std::time_t from, std::time_t to) const {
+        return summarizeRows(lowerBound(from), lowerBound(to));
+    }
+
+    std::vector<Transaction> list(std::time_t from, std::time_t to) const {
+        std::vector<Transaction> rows;
+        for (size_t i = lowerBound(from), last = lowerBound(to); i < last; ++i) {
+            rows.push_back(at(i));
+        }
+        return rows;
+    }
+
+    std::vector<Transaction> list(std::time_t from, std::time_t to, TransactionType type) const {
+        std::vector<Transaction> rows;
+        for (size_t i = lowerBound(from), last = lowerBound(to); i < last; ++i) {
+            if (typeAt(i) == type) {
+                rows.push_back(at(i));
+            }
+        }
+        return rows;
+    }
+
+    size_t size() const { return count; }
+
+    TransactionType typeAt(size_t index) const {
+        Location row = locate(index);
+        bool isWithdrawal = (chunks[row.chunk]->withdrawalBits[row.slot / 64] >> (row.slot % 64)) & 1;
+        return isWithdrawal ? TransactionType::WITHDRAWAL : TransactionType::DEPOSIT;
+    }
+
+    int64_t amountCentsAt(size_t index) const {
+        Location row = locate(index);
+        return chunks[row.chunk]->amountCents[row.slot];
+    }
+
+    std::time_t timestampAt(size_t index) const {
+        Location row = locate(index);
+        return chunks[row.chunk]->timestamps[row.slot];
+    }
+
+    const std::string& descriptionAt(size_t index) const {
+        return descriptions[descriptionIdAt(index)];
+    }
+
+    Transaction at(size_t index) const {
+        return Transaction(typeAt(index), amountCentsAt(index) / 100.0, descriptionAt(index), timestampAt(index));
+    }
+
+    size_t getDescriptionCount() const { return descriptions.size(); }
+    size_t getChunkCapacity() const { return FIRST_CHUNK_SIZE * ((size_t(1) << chunks.size()) - 1); }
+    int64_t getDepositCents() const { return depositCents; }
+    int64_t getWithdrawalCents() const { return withdrawalCents; }
+};
+
+// Streams statement rows into any std::ostream through one reusable buffer,
+// so exporting millions of rows allocates nothing per row
+class StatementWriter {
+private:
+    static const size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::ostream& out;
+    StatementRenderer renderer;
+    std::string buffer;
+    size_t rowsWritten = 0;
+
+public:
+    explicit StatementWriter(std::ostream& out) : out(out) {
+        buffer.reserve(FLUSH_THRESHOLD + 256);
+    }
+
+    StatementWriter(const StatementWriter&) = delete;
+    StatementWriter& operator=(const StatementWriter&) = delete;
+
+    ~StatementWriter() {
+        flush();
+    }
+
+    void writeRow(TransactionType type, int64_t cents, std::time_t timestamp, std::string_view description) {
+        renderer.appendRow(buffer, type, cents, timestamp, description);
+        buffer += '\n';
+        rowsWritten++;
+        if (buffer.size() >= FLUSH_THRESHOLD) {
+            flush();
+        }
+    }
+
+    void writeLedger(const TransactionLedger& ledger) {
+        for (size_t i = 0; i < ledger.size(); ++i) {
+            writeRow(ledger.typeAt(i), ledger.amountCentsAt(i), ledger.timestampAt(i), ledger.descriptionAt(i));
+        }
+    }
+
+    void flush() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    size_t getRowsWritten() const { return rowsWritten; }
+};
+
+class BankAccount {
+private:
+    int64_t balanceCents;
+    TransactionLedger ledger;
+
+    static int64_t toCents(double amount) {
+        return std::llround(amount * 100.0);
+    }
+
+public:
+    explicit BankAccount(double initialBalance = 0) : balanceCents(toCents(initialBalance)) {
+        if (initialBalance < 0) {
+            throw std::invalid_argument("Initial balance cannot be negative");
+        }
+        
+        if (balanceCents > 0) {
+            ledger.append(TransactionType::DEPOSIT, balanceCents, "Initial deposit", ledger.nextTimestamp());
+        }
+    }
+
+    double getBalance() const {
+        return balanceCents / 100.0;
+    }
+
+    const TransactionLedger& getLedger() const {
+        return ledger;
+    }
+
+    TransactionSummary summarizeBetween(std::time_t from, std::time_t to) const {
+        return ledger.summarize(from, to);
+    }
+
+    // Materializes the columnar ledger; prefer getLedger() for large histories
+    std::vector<Transaction> getTransactionHistory() const {
+        std::vector<Transaction> history;
+        history.reserve(ledger.size());
+        for (size_t i = 0; i < ledger.size(); ++i) {
+            history.push_back(ledger.at(i));
+        }
+        return history;
+    }
+
+    void deposit(double amount, const std::string& description = "Deposit") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Deposit amount must be positive");
+        }
+
+        balanceCents += cents;
+        ledger.append(TransactionType::DEPOSIT, cents, description, ledger.nextTimestamp());
+    }
+
+    void withdraw(double amount, const std::string& description = "Withdrawal") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Withdrawal amount must be positive");
+        }
+
+        if (cents > balanceCents) {
+            throw std::runtime_error("Insufficient funds");
+        }
+
+        balanceCents -= cents;
+        ledger.append(TransactionType::WITHDRAWAL, cents, description, ledger.nextTimestamp());
+    }
+
+    double getTotalDeposits() const {
+        return ledger.getDepositCents() / 100.0;
+    }
+
+    double getTotalWithdrawals() const {
+        return ledger.getWithdrawalCents() / 100.0;
+    }
+};
+
+// Example 4b: Bank account shared between request threads
+// The balance is one atomic in cents. Withdrawals use a compare-and-swap loop,
+// so the insufficient-funds check and the debit happen as a single step.
+// Ledger rows go through a lock-free multi-producer queue and are drained
+// into the columnar ledger by whichever reader next asks for history, or by a
+// writer once DRAIN_THRESHOLD rows are pending, so a write-only account keeps
+// a bounded queue.
+class ConcurrentBankAccount {
+private:
+    struct LogEntry {
+        TransactionType type = TransactionType::DEPOSIT;
+        int64_t amountCents = 0;
+        std::string description;
+        std::time_t timestamp = 0;
+        std::atomic<LogEntry*> next{nullptr};
+    };
+
+    static const size_t DRAIN_THRESHOLD = 1024;
+
+    std::atomic<int64_t> balanceCents;
+    std::atomic<LogEntry*> logHead;    // producers append here
+    LogEntry* logTail;                 // consumer side; always a consumed entry
+    std::atomic<size_t> pendingEntries{0};
+    std::mutex ledgerMutex;            // one consumer at a time
+    TransactionLedger ledger;
+
+    static int64_t toCents(double amount) {
+        return std::llround(amount * 100.0);
+    }
+
+    // Built before the balance changes, so a failed allocation leaves the
+    // account untouched
+    static std::unique_ptr<LogEntry> makeEntry(TransactionType type, int64_t cents, const std::string& description) {
+        auto entry = std::make_unique<LogEntry>();
+        entry->type = type;
+        entry->amountCents = cents;
+        entry->description = description;
+        entry->timestamp = std::time(nullptr);
+        return entry;
+    }
+
+    void publish(std::unique_ptr<LogEntry> entry) {
+        LogEntry* raw = entry.release();
+        LogEntry* previous = logHead.exchange(raw, std::memory_order_acq_rel);
+        previous->next.store(raw, std::memory_order_release);
+
+        if (pendingEntries.fetch_add(1, std::memory_order_relaxed) + 1 >= DRAIN_THRESHOLD) {
+            // Skip if another thread is already draining
+            std::unique_lock<std::mutex> lock(ledgerMutex, std::try_to_lock);
+            if (lock.owns_lock()) {
+                drainLogLocked();
+            }
+        }
+    }
+
+    // Caller holds ledgerMutex
+    void drainLogLocked() {
+        size_t drained = 0;
+        LogEntry* next = logTail->next.load(std::memory_order_acquire);
+        while (next != nullptr) {
+            // Entries are stamped before they are published, so one can carry
+            // the second before its predecessor's; it is recorded at that second
+            ledger.append(next->type, next->amountCents, next->description, ledger.orderedTimestamp(next->timestamp));
+            delete logTail;
+            logTail = next;
+            next = logTail->next.load(std::memory_order_acquire);
+            drained++;
+        }
+        pendingEntries.fetch_sub(drained, std::memory_order_relaxed);
+    }
+
+public:
+    explicit ConcurrentBankAccount(double initialBalance = 0)
+        : balanceCents(toCents(initialBalance)), logHead(new LogEntry), logTail(logHead.load()) {
+        if (initialBalance < 0) {
+            delete logTail;
+            throw std::invalid_argument("Initial balance cannot be negative");
+        }
+
+        if (balanceCents.load() > 0) {
+            publish(makeEntry(TransactionType::DEPOSIT, balanceCents.load(), "Initial deposit"));
+        }
+    }
+
+    ConcurrentBankAccount(const ConcurrentBankAccount&) = delete;
+    ConcurrentBankAccount& operator=(const ConcurrentBankAccount&) = delete;
+
+    ~ConcurrentBankAccount() {
+        LogEntry* entry = logTail;
+        while (entry != nullptr) {
+            LogEntry* next = entry->next.load(std::memory_order_relaxed);
+            delete entry;
+            entry = next;
+        }
+    }
+
+    double getBalance() const {
+        return balanceCents.load(std::memory_order_acquire) / 100.0;
+    }
+
+    void deposit(double amount, const std::string& description = "Deposit") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Deposit amount must be positive");
+        }
+
+        auto entry = makeEntry(TransactionType::DEPOSIT, cents, description);
+        balanceCents.fetch_add(cents, std::memory_order_acq_rel);
+        publish(std::move(entry));
+    }
+
+    void withdraw(double amount, const std::string& description = "Withdrawal") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Withdrawal amount must be positive");
+        }
+
+        auto entry = makeEntry(TransactionType::WITHDRAWAL, cents, description);
+        int64_t current = balanceCents.load(std::memory_order_acquire);
+        do {
+            if (cents > current) {
+                throw std::runtime_error("Insufficient funds");
+            }
+        } while (!balanceCents.compare_exchange_weak(current, current - cents, std::memory_order_acq_rel));
+
+        publish(std::move(entry));
+    }
+
+    // Rows published but not yet drained into the ledger
+    size_t getPendingLogEntries() const {
+        return pendingEntries.load(std::memory_order_relaxed);
+    }
+
+    // Ledger reads see every operation whose log append has completed
+    size_t getTransactionCount() {
+        std::lock_guard<std::mutex> lock(ledgerMutex);
+        drainLogLocked();
+        return ledger.size();
+    }
+
+    double getTotalDeposits() {
+        std::lock_guard<std::mutex> lock(ledgerMutex);
+        drainLogLocked();
+        return ledger.getDepositCents() / 100.0;
+    }
+
+    double getTotalWithdrawals() {
+        std::lock_guard<std::mutex> lock(ledgerMutex);
+        drainLogLocked();
+        return ledger.getWithdrawalCents() / 100.0;
+    }
+
+    std::vector<Transaction> getTransactionHistory() {
+        std::lock_guard<std::mutex> lock(ledgerMutex);
+        drainLogLocked();
+        std::vector<Transaction> history;
+        history.reserve(ledger.size());
+        for (size_t i = 0; i < ledger.size(); ++i) {
+            history.push_back(ledger.at(i));
+        }
+        return history;
+    }
+};
+
+// Work-stealing pool: each worker drains its own queue from the front and,
+// once empty, steals from the back of another worker's queue. Helper threads
+// are started once and sleep between runs; the calling thread is worker 0.
+class WorkStealingPool {
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<WorkQueue> queues; // one per worker
+    std::vector<std::thread> helpers;
+    std::mutex runMutex; // one run() at a time
+
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* currentTask = nullptr;
+    size_t activeWorkers = 0;
+    size_t busyHelpers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr failure;
+
+    static bool popFront(WorkQueue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    static bool stealBack(WorkQueue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    void drain(size_t self, size_t workers, const std::function<void(size_t)>& task) {
+        size_t next;
+        while (true) {
+            bool found = popFront(queues[self], next);
+            for (size_t offset = 1; offset < workers && !found; ++offset) {
+                found = stealBack(queues[(self + offset) % workers], next);
+            }
+            if (!found) {
+                return; // no task spawns more work, so empty queues mean done
+            }
+            try {
+                task(next);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void helperLoop(size_t self) {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* task;
+            size_t workers;
+            {
+                std::unique_lock<std::mutex> lock(stateMutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+                task = currentTask;
+                workers = activeWorkers;
+            }
+            if (self >= workers) {
+                continue; // a small run that does not need this helper
+            }
+
+            drain(self, workers, *task);
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--busyHelpers == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit WorkStealingPool(size_t threadCount) : queues(std::max<size_t>(1, threadCount)) {
+        for (size_t w = 1; w < queues.size(); ++w) {
+            helpers.emplace_back(&WorkStealingPool::helperLoop, this, w);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t getThreadCount() const { return queues.size(); }
+
+    // Runs task(0) .. task(taskCount - 1) and returns once all have finished.
+    // If tasks throw, the rest still run and the first exception is rethrown.
+    // Concurrent calls take turns; a task must not call run() on its own pool.
+    void run(size_t taskCount, const std::function<void(size_t)>& task) {
+        std::lock_guard<std::mutex> runLock(runMutex);
+        size_t workers = std::min(queues.size(), std::max<size_t>(1, taskCount));
+        for (size_t i = 0; i < taskCount; ++i) {
+            queues[i % workers].tasks.push_back(i);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            currentTask = &task;
+            activeWorkers = workers;
+            busyHelpers = workers - 1;
+            ++generation;
+        }
+        if (workers > 1) {
+            wake.notify_all();
+        }
+
+        drain(0, workers, task);
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            finished.wait(lock, [&]() { return busyHelpers == 0; });
+            error = std::exchange(failure, nullptr);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+// Example 4c: Sharded multi-account store
+// Accounts are spread over shards by id; each shard owns a mutex and a dense
+// array of balances in cents. A transfer locks the (at most two) shards it
+// touches in ascending shard order, so concurrent transfers cannot deadlock.
+enum class TransferStatus : uint8_t {
+    COMPLETED,
+    INSUFFICIENT_FUNDS,
+    UNKNOWN_ACCOUNT,
+    SAME_ACCOUNT,
+    INVALID_AMOUNT,
+    BALANCE_OVERFLOW // the credit would overflow the destination's int64 cents
+};
+
+struct TransferRequest {
+    uint64_t fromAccount;
+    uint64_t toAccount;
+    int64_t amountCents;
+};
+
+struct AccountStoreStats {
+    uint64_t completed = 0;
+    uint64_t rejected = 0;
+    double averageLatencyNanos = 0;
+    uint64_t maxLatencyNanos = 0;
+};
+
+class AccountStore {
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<int64_t> balances;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t accountCount;
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> rejected{0};
+    std::atomic<uint64_t> totalLatencyNanos{0};
+    std::atomic<uint64_t> maxLatencyNanos{0};
+
+    Shard& shardOf(uint64_t account) { return *shards[account % shards.size()]; }
+    size_t slotOf(uint64_t account) const { return account / shards.size(); }
+
+    TransferStatus transferLocked(uint64_t from, uint64_t to, int64_t cents) {
+        int64_t& fromBalance = shardOf(from).balances[slotOf(from)];
+        int64_t& toBalance = shardOf(to).balances[slotOf(to)];
+        if (fromBalance < cents) {
+            return TransferStatus::INSUFFICIENT_FUNDS;
+        }
+        if (toBalance > std::numeric_limits<int64_t>::max() - cents) {
+            return TransferStatus::BALANCE_OVERFLOW;
+        }
+        fromBalance -= cents;
+        toBalance += cents;
+        return TransferStatus::COMPLETED;
+    }
+
+    TransferStatus executeTransfer(uint64_t from, uint64_t to, int64_t cents) {
+        if (from >= accountCount || to >= accountCount) return TransferStatus::UNKNOWN_ACCOUNT;
+        if (from == to) return TransferStatus::SAME_ACCOUNT;
+        if (cents <= 0) return TransferStatus::INVALID_AMOUNT;
+
+        size_t fromShard = from % shards.size();
+        size_t toShard = to % shards.size();
+        if (fromShard == toShard) {
+            std::lock_guard<std::mutex> lock(shards[fromShard]->mutex);
+            return transferLocked(from, to, cents);
+        }
+
+        std::lock_guard<std::mutex> first(shards[std::min(fromShard, toShard)]->mutex);
+        std::lock_guard<std::mutex> second(shards[std::max(fromShard, toShard)]->mutex);
+        return transferLocked(from, to, cents);
+    }
+
+    void recordLatency(uint64_t nanos, TransferStatus status) {
+        (status == TransferStatus::COMPLETED ? completed : rejected).fetch_add(1, std::memory_order_relaxed);
+        totalLatencyNanos.fetch_add(nanos, std::memory_order_relaxed);
+        uint64_t currentMax = maxLatencyNanos.load(std::memory_order_relaxed);
+        while (nanos > currentMax && !maxLatencyNanos.compare_exchange_weak(currentMax, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+public:
+    AccountStore(size_t accountCount, int64_t initialBalanceCents, size_t shardCount = 64)
+        : accountCount(accountCount) {
+        if (shardCount == 0) {
+            throw std::invalid_argument("Shard count must be positive");
+        }
+        for (size_t i = 0; i < shardCount; ++i) {
+            auto shard = std::make_unique<Shard>();
+            shard->balances.assign(accountCount / shardCount + 1, initialBalanceCents);
+            shards.push_back(std::move(shard));
+        }
+    }
+
+    size_t getAccountCount() const { return accountCount; }
+
+    int64_t getBalanceCents(uint64_t account) {
+        if (account >= accountCount) {
+            throw std::out_of_range("Unknown account");
+        }
+        Shard& shard = shardOf(account);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.balances[slotOf(account)];
+    }
+
+    // Consistent sum: holds every shard lock while adding
+    int64_t getTotalBalanceCents() {
+        std::vector<std::unique_lock<std::mutex>> locks;
+        for (auto& shard : shards) {
+            locks.emplace_back(shard->mutex);
+        }
+
+        int64_t total = 0;
+        for (uint64_t account = 0; account < accountCount; ++account) {
+            total += shardOf(account).balances[slotOf(account)];
+        }
+        return total;
+    }
+
+    TransferStatus transfer(uint64_t from, uint64_t to, int64_t amountCents) {
+        auto start = std::chrono::steady_clock::now();
+        TransferStatus status = executeTransfer(from, to, amountCents);
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        recordLatency(static_cast<uint64_t>(nanos), status);
+        return status;
+    }
+
+    // Runs the batch on the caller's pool in fixed-size chunks, so idle
+    // workers can steal chunks from busy ones
+    std::vector<TransferStatus> processBatch(const std::vector<TransferRequest>& batch, WorkStealingPool& pool) {
+        const size_t chunkSize = 1024;
+        std::vector<TransferStatus> results(batch.size());
+        pool.run((batch.size() + chunkSize - 1) / chunkSize, [&](size_t chunk) {
+            size_t end = std::min(batch.size(), (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; ++i) {
+                results[i] = transfer(batch[i].fromAccount, batch[i].toAccount, batch[i].amountCents);
+            }
+        });
+        return results;
+    }
+
+    AccountStoreStats getStats() const {
+        AccountStoreStats stats;
+        stats.completed = completed.load(std::memory_order_relaxed);
+        stats.rejected = rejected.load(std::memory_order_relaxed);
+        uint64_t total = stats.completed + stats.rejected;
+        stats.averageLatencyNanos = total > 0 ? static_cast<double>(totalLatencyNanos.load()) / total : 0.0;
+        stats.maxLatencyNanos = maxLatencyNanos.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+// Example 4d: Durable bank account
+// Every deposit/withdrawal is appended to a binary write-ahead log (WAL) and
+// applied in memory, and by default the call returns only once the record is
+// fsynced. Records are group-committed: while one caller writes and fsyncs a
+// batch, records from other callers collect behind it. The first waiter then
+// commits them all in one fsync, once the batch is full or its oldest record
+// has waited maxDelay. With waitForSync off, calls return as soon as the
+// record is buffered and a background flusher commits it within maxDelay; a
+// crash in that window loses records the caller already saw succeed.
+// After a failed write or fsync the log refuses further records, and the
+// account must be reopened so recovery rebuilds its state from the disk.
+// Snapshots store the balances and the WAL offset they cover, so recovery
+// replays only the tail.
+struct GroupCommitPolicy {
+    size_t maxBatchRecords = 64;
+    std::chrono::microseconds maxDelay{1000};
+    bool waitForSync = true;
+};
+
+class WriteAheadLog {
+public:
+    struct Record {
+        uint64_t sequence;
+        TransactionType type;
+        int64_t amountCents;
+        int64_t timestamp;
+        std::string description;
+    };
+
+private:
+    static const size_t HEADER_SIZE = 8 + 8 + 8 + 1 + 2; // sequence, amount, timestamp, type, description length
+    static const size_t CHECKSUM_SIZE = 4;
+
+    std::FILE* file = nullptr;
+    GroupCommitPolicy policy;
+    std::vector<char> pending;
+    std::vector<char> writing; // the batch being written; reused so commits do not allocate
+    size_t pendingRecords = 0;
+    std::chrono::steady_clock::time_point oldestPending;
+    uint64_t appendedOffset = 0;  // end of the last buffered record
+    uint64_t committedOffset = 0; // end of the last fsynced record
+    uint64_t syncCount = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable changed; // a batch filled, a commit finished, or stopping
+    bool committing = false;         // a batch is being written outside the lock
+    bool stopping = false;
+    std::exception_ptr failure;      // the first failed commit; the log is unusable after it
+    std::thread flusher;
+
+    static uint32_t checksum(const char* data, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    template<typename T>
+    static void put(std::vector<char>& out, T value) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    static T get(const char* in) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        return value;
+    }
+
+    void rethrowFailure() const {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    bool batchDue() const {
+        return pendingRecords >= policy.maxBatchRecords ||
+               std::chrono::steady_clock::now() - oldestPending >= policy.maxDelay;
+    }
+
+    // Writes and fsyncs the pending batch with the lock released, so other
+    // callers keep appending to the next batch meanwhile. A failure drops the
+    // batch and poisons the log: nothing after a lost record may reach disk.
+    void commitLocked(std::unique_lock<std::mutex>& lock) {
+        rethrowFailure();
+        if (pending.empty()) {
+            return;
+        }
+        writing.swap(pending);
+        pending.clear();
+        pendingRecords = 0;
+        committing = true;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            if (std::fwrite(writing.data(), 1, writing.size(), file) != writing.size() || std::fflush(file) != 0) {
+                throw std::runtime_error("Write-ahead log write failed");
+            }
+            syncToDisk(file);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        committing = false;
+        if (error) {
+            failure = error;
+        } else {
+            syncCount++;
+            committedOffset += writing.size();
+        }
+        changed.notify_all();
+        rethrowFailure();
+    }
+
+    // Commits batches nobody is waiting on (write-behind mode, or a caller
+    // that has not reached waitDurable yet)
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (pendingRecords == 0 || committing || failure) {
+                changed.wait(lock);
+            } else if (batchDue()) {
+                try {
+                    commitLocked(lock);
+                } catch (...) {
+                    // Kept in failure and reported to the next caller
+                }
+            } else {
+                changed.wait_until(lock, oldestPending + policy.maxDelay);
+            }
+        }
+    }
+
+public:
+    // fsync/_commit a stream's file, throwing if the data may not be on disk
+    static void syncToDisk(std::FILE* stream) {
+#ifdef _WIN32
+        int result = _commit(_fileno(stream));
+#else
+        int result = fsync(fileno(stream));
+#endif
+        if (result != 0) {
+            throw std::runtime_error("Syncing file to disk failed");
+        }
+    }
+
+    WriteAheadLog(const std::string& path, GroupCommitPolicy policy) : policy(policy) {
+        file = std::fopen(path.c_str(), "ab");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open write-ahead log: " + path);
+        }
+        std::fseek(file, 0, SEEK_END);
+        committedOffset = static_cast<uint64_t>(std::ftell(file));
+        appendedOffset = committedOffset;
+        flusher = std::thread(&WriteAheadLog::flushLoop, this);
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Destructors must not throw, so a final commit that fails is reported
+    // on stderr; the file is closed either way
+    ~WriteAheadLog() {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        changed.notify_all();
+        lock.unlock();
+        flusher.join();
+
+        lock.lock();
+        try {
+            commitLocked(lock);
+        } catch (const std::exception& ex) {
+            std::cerr << "Write-ahead log: final commit failed: " << ex.what() << std::endl;
+        }
+        std::fclose(file);
+    }
+
+    // Buffers a record and returns the log offset it ends at; the record is
+    // durable once waitDurable(offset) returns. Never writes, so it is cheap
+    // to call under the caller's own lock.
+    uint64_t append(const Record& record) {
+        if (record.description.size() > UINT16_MAX) {
+            throw std::invalid_argument("Description too long for write-ahead log");
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        rethrowFailure();
+        size_t start = pending.size();
+        put(pending, record.sequence);
+        put(pending, record.amountCents);
+        put(pending, record.timestamp);
+        put(pending, static_cast<uint8_t>(record.type));
+        put(pending, static_cast<uint16_t>(record.description.size()));
+        pending.insert(pending.end(), record.description.begin(), record.description.end());
+        put(pending, checksum(pending.data() + start, pending.size() - start));
+        appendedOffset += pending.size() - start;
+
+        if (pendingRecords++ == 0) {
+            oldestPending = std::chrono::steady_clock::now();
+            changed.notify_all(); // the flusher starts timing this batch
+        } else if (pendingRecords == policy.maxBatchRecords) {
+            changed.notify_all(); // a waiting leader can commit now
+        }
+        return appendedOffset;
+    }
+
+    // Blocks until everything up to offset is fsynced. A waiter finding no
+    // commit in flight becomes the leader: it holds the batch open until it
+    // is full or maxDelay has passed, then commits it for every waiter.
+    void waitDurable(uint64_t offset) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (committedOffset < offset) {
+            rethrowFailure();
+            if (committing) {
+                changed.wait(lock);
+            } else if (batchDue()) {
+                commitLocked(lock);
+            } else {
+                changed.wait_until(lock, oldestPending + policy.maxDelay);
+            }
+        }
+    }
+
+    // Writes and fsyncs everything buffered without waiting for the batch to fill
+    void commit() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t target = appendedOffset;
+        while (committedOffset < target) {
+            rethrowFailure();
+            if (committing) {
+                changed.wait(lock);
+            } else {
+                commitLocked(lock);
+            }
+        }
+        rethrowFailure();
+    }
+
+    uint64_t getCommittedOffset() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return committedOffset;
+    }
+
+    uint64_t getSyncCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return syncCount;
+    }
+
+    // Replays intact records from offset; returns the offset just past the
+    // last intact record, so a torn tail from a crash can be cut off
+    template<typename Visit>
+    static uint64_t replay(const std::string& path, uint64_t offset, Visit&& visit) {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            return offset;
+        }
+        input.seekg(static_cast<std::streamoff>(offset));
+
+        std::vector<char> buffer(HEADER_SIZE + UINT16_MAX + CHECKSUM_SIZE);
+        while (input.read(buffer.data(), HEADER_SIZE)) {
+            uint16_t descriptionLength = get<uint16_t>(buffer.data() + 25);
+            size_t bodySize = descriptionLength + CHECKSUM_SIZE;
+            if (!input.read(buffer.data() + HEADER_SIZE, static_cast<std::streamsize>(bodySize))) {
+                break;
+            }
+            size_t recordSize = HEADER_SIZE + descriptionLength;
+            if (get<uint32_t>(buffer.data() + recordSize) != checksum(buffer.data(), recordSize)) {
+                break;
+            }
+
+            Record record;
+            record.sequence = get<uint64_t>(buffer.data());
+            record.amountCents = get<int64_t>(buffer.data() + 8);
+            record.timestamp = get<int64_t>(buffer.data() + 16);
+            record.type = static_cast<TransactionType>(get<uint8_t>(buffer.data() + 24));
+            record.description.assign(buffer.data() + HEADER_SIZE, descriptionLength);
+            visit(record);
+            offset += recordSize + CHECKSUM_SIZE;
+        }
+        return offset;
+    }
+};
+
+class DurableBankAccount {
+private:
+    struct Snapshot {
+        uint64_t magic;
+        int64_t balanceCents;
+        int64_t depositCents;
+        int64_t withdrawalCents;
+        uint64_t nextSequence;
+        uint64_t walOffset;
+    };
+
+    static const uint64_t SNAPSHOT_MAGIC = 0x31504e5354434341ULL; // "ACCTSNP1"
+
+    std::string walPath;
+    std::string snapshotPath;
+    GroupCommitPolicy policy;
+    size_t snapshotInterval;
+    size_t sinceSnapshot = 0;
+    mutable std::mutex stateMutex; // balances, sequence and history; never held while waiting for fsync
+    int64_t balanceCents = 0;
+    int64_t depositCents = 0;
+    int64_t withdrawalCents = 0;
+    uint64_t nextSequence = 1;
+    size_t replayedRecords = 0;
+    TransactionLedger recentHistory; // WAL records replayed after the snapshot, then new operations
+    std::unique_ptr<WriteAheadLog> wal;
+
+    static int64_t toCents(double amount) {
+        return std::llround(amount * 100.0);
+    }
+
+    void apply(TransactionType type, int64_t cents, const std::string& description, std::time_t timestamp) {
+        if (type == TransactionType::DEPOSIT) {
+            balanceCents += cents;
+            depositCents += cents;
+        } else {
+            balanceCents -= cents;
+            withdrawalCents += cents;
+        }
+        recentHistory.append(type, cents, description, timestamp);
+    }
+
+    // The record is buffered in the log before memory changes, and a failed
+    // append changes neither, so memory never holds a record the log lacks
+    void record(TransactionType type, int64_t cents, const std::string& description) {
+        uint64_t durableAt = 0;
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (type == TransactionType::WITHDRAWAL && cents > balanceCents) {
+                throw std::runtime_error("Insufficient funds");
+            }
+
+            std::time_t now = recentHistory.nextTimestamp();
+            durableAt = wal->append({nextSequence, type, cents, static_cast<int64_t>(now), description});
+            nextSequence++;
+            apply(type, cents, description, now);
+
+            if (snapshotInterval > 0 && ++sinceSnapshot >= snapshotInterval) {
+                snapshotLocked();
+            }
+        }
+
+        if (policy.waitForSync) {
+            wal->waitDurable(durableAt);
+        }
+    }
+
+    void recover() {
+        uint64_t walOffset = 0;
+        std::ifstream input(snapshotPath, std::ios::binary);
+        Snapshot saved{};
+        if (input.read(reinterpret_cast<char*>(&saved), sizeof(saved)) && saved.magic == SNAPSHOT_MAGIC) {
+            balanceCents = saved.balanceCents;
+            depositCents = saved.depositCents;
+            withdrawalCents = saved.withdrawalCents;
+            nextSequence = saved.nextSequence;
+            walOffset = saved.walOffset;
+        }
+
+        // A snapshot covering more log than exists means the log was lost or
+        // replaced; appending to it would silently skip records on recovery
+        std::error_code sizeError;
+        uint64_t walSize = std::filesystem::exists(walPath) ? std::filesystem::file_size(walPath, sizeError) : 0;
+        if (sizeError || walOffset > walSize) {
+            throw std::runtime_error("Snapshot covers " + std::to_string(walOffset) +
+                                     " bytes of write-ahead log but the log has " + std::to_string(walSize));
+        }
+
+        uint64_t validEnd = WriteAheadLog::replay(walPath, walOffset, [this](const WriteAheadLog::Record& entry) {
+            apply(entry.type, entry.amountCents, entry.description, static_cast<std::time_t>(entry.timestamp));
+            nextSequence = entry.sequence + 1;
+            replayedRecords++;
+        });
+
+        // Drop a torn tail. If it stayed, new records would be appended after
+        // the garbage and lost on the next replay, so failing here is safer.
+        if (walSize > validEnd) {
+            std::error_code error;
+            std::filesystem::resize_file(walPath, validEnd, error);
+            if (error) {
+                throw std::runtime_error("Cannot truncate torn write-ahead log tail: " + error.message());
+            }
+        }
+    }
+
+    // Commits the log, then atomically replaces the snapshot file. The new
+    // file is fsynced before the rename, so a crash leaves either the old or
+    // the complete new snapshot, never an empty or partial one.
+    void snapshotLocked() {
+        wal->commit();
+        Snapshot current{SNAPSHOT_MAGIC, balanceCents, depositCents, withdrawalCents, nextSequence, wal->getCommittedOffset()};
+
+        std::string temporaryPath = snapshotPath + ".tmp";
+        std::FILE* output = std::fopen(temporaryPath.c_str(), "wb");
+        if (output == nullptr) {
+            throw std::runtime_error("Cannot write snapshot: " + temporaryPath);
+        }
+        bool written = std::fwrite(&current, sizeof(current), 1, output) == 1 && std::fflush(output) == 0;
+        try {
+            if (written) {
+                WriteAheadLog::syncToDisk(output);
+            }
+        } catch (...) {
+            written = false;
+        }
+        if (std::fclose(output) != 0 || !written) {
+            throw std::runtime_error("Cannot write snapshot: " + temporaryPath);
+        }
+        std::filesystem::rename(temporaryPath, snapshotPath);
+        sinceSnapshot = 0;
+    }
+
+public:
+    DurableBankAccount(const std::string& pathPrefix, GroupCommitPolicy policy = {}, size_t snapshotInterval = 100000)
+        : walPath(pathPrefix + ".wal"), snapshotPath(pathPrefix + ".snapshot"), policy(policy),
+          snapshotInterval(snapshotInterval) {
+        recover();
+        wal = std::make_unique<WriteAheadLog>(walPath, policy);
+    }
+
+    // Balances include records still waiting for their group commit
+    double getBalance() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return balanceCents / 100.0;
+    }
+
+    double getTotalDeposits() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return depositCents / 100.0;
+    }
+
+    double getTotalWithdrawals() const {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return withdrawalCents / 100.0;
+    }
+
+    size_t getReplayedRecordCount() const { return replayedRecords; }
+    uint64_t getSyncCount() const { return wal->getSyncCount(); }
+
+    // Not synchronized: read it only while no deposit or withdrawal is running
+    const TransactionLedger& getRecentHistory() const { return recentHistory; }
+
+    // Safe to call from many threads; concurrent callers share fsyncs
+    void deposit(double amount, const std::string& description = "Deposit") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Deposit amount must be positive");
+        }
+        record(TransactionType::DEPOSIT, cents, description);
+    }
+
+    void withdraw(double amount, const std::string& description = "Withdrawal") {
+        int64_t cents = toCents(amount);
+        if (cents <= 0) {
+            throw std::invalid_argument("Withdrawal amount must be positive");
+        }
+        record(TransactionType::WITHDRAWAL, cents, description);
+    }
+
+    void commit() {
+        wal->commit();
+    }
+
+    void snapshot() {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        snapshotLocked();
+    }
+
+    static void removeFiles(const std::string& pathPrefix) {
+        std::error_code error;
+        for (const char* suffix : {".wal", ".snapshot", ".snapshot.tmp"}) {
+            std::filesystem::remove(pathPrefix + suffix, error);
+        }
+    }
+};
+
+// Example 5: String Calculator (TDD Kata)
+// Delimiters compiled into a byte-class table: a single lookup tells whether
+// a byte is a delimiter, may start a longer delimiter, or is ordinary input.
+// ',' and newline are always delimiters; a "//" header adds custom ones.
+class DelimiterSet {
+private:
+    static const uint8_t SINGLE = 1;
+    static const uint8_t MULTI_START = 2;
+
+    std::array<uint8_t, 256> classes{};
+    std::vector<std::string> multiByte; // longest first, so the longest match wins
+    size_t longest = 1;
+
+    void addDelimiter(std::string_view delimiter) {
+        if (delimiter.empty()) {
+            throw std::invalid_argument("Delimiter cannot be empty");
+        }
+        // Digits, signs and blanks belong to numbers; as delimiters they would
+        // change how numbers are read. This also lets readChunks treat a digit
+        // as something no delimiter can cover.
+        for (char c : delimiter) {
+            if ((c >= '0' && c <= '9') || c == '+' || c == '-' || c == ' ' || (c >= '\t' && c <= '\r' && c != '\n')) {
+                throw std::invalid_argument("Delimiter cannot contain digits, signs or blanks");
+            }
+        }
+        longest = std::max(longest, delimiter.size());
+        if (delimiter.size() == 1) {
+            classes[static_cast<unsigned char>(delimiter[0])] |= SINGLE;
+            return;
+        }
+        // Keeps ',' and newline safe places to split input into chunks
+        if (delimiter.find_first_of(",\n") != std::string_view::npos) {
+            throw std::invalid_argument("Multi-character delimiter cannot contain ',' or newline");
+        }
+
+        classes[static_cast<unsigned char>(delimiter[0])] |= MULTI_START;
+        multiByte.emplace_back(delimiter);
+        std::stable_sort(multiByte.begin(), multiByte.end(),
+            [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
+    }
+
+public:
+    DelimiterSet() {
+        addDelimiter(",");
+        addDelimiter("\n");
+    }
+
+    // header is the text between "//" and the first newline:
+    // ";" (one delimiter) or "[***][%]" (any number of bracketed delimiters)
+    static DelimiterSet fromHeader(std::string_view header) {
+        DelimiterSet delimiters;
+        if (header.empty() || header[0] != '[') {
+            delimiters.addDelimiter(header);
+            return delimiters;
+        }
+
+        while (!header.empty()) {
+            size_t close = header.find(']');
+            if (header[0] != '[' || close == std::string_view::npos) {
+                throw std::invalid_argument("Malformed delimiter header");
+            }
+            delimiters.addDelimiter(header.substr(1, close - 1));
+            header.remove_prefix(close + 1);
+        }
+        return delimiters;
+    }
+
+    size_t getLongestLength() const {
+        return longest;
+    }
+
+    // Length of the delimiter starting at position, or 0
+    size_t matchAt(const char* position, const char* end) const {
+        uint8_t byteClass = classes[static_cast<unsigned char>(*position)];
+        if (byteClass == 0) {
+            return 0;
+        }
+        if (byteClass & MULTI_START) {
+            size_t available = static_cast<size_t>(end - position);
+            for (const auto& delimiter : multiByte) {
+                if (delimiter.size() <= available && std::memcmp(position, delimiter.data(), delimiter.size()) == 0) {
+                    return delimiter.size();
+                }
+            }
+        }
+        return (byteClass & SINGLE) ? 1 : 0;
+    }
+};
+
+// add() parses in a single pass over a string_view: no copies, no per-token
+// strings, no exceptions for skipped tokens. Tokens follow std::stoi rules
+// (leading blanks, optional sign, trailing junk ignored, no digits = skipped).
+class StringCalculator {
+private:
+    static const DelimiterSet DEFAULT_DELIMITERS;
+
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    [[noreturn]] static void throwNegatives(const std::vector<int>& negatives) {
+        std::string errorMessage = "Negatives not allowed: ";
+        for (size_t i = 0; i < negatives.size(); ++i) {
+            if (i > 0) errorMessage += ", ";
+            errorMessage += std::to_string(negatives[i]);
+        }
+        throw std::runtime_error(errorMessage);
+    }
+
+    // Running result for one piece of input; pieces merge in input order
+    struct PartialSum {
+        int64_t sum = 0;
+        bool overflowed = false;
+        std::vector<int> negatives;
+
+        void addValue(int64_t value) {
+            if (sum > INT64_MAX - value) {
+                overflowed = true;
+            } else {
+                sum += value;
+            }
+        }
+
+        void merge(PartialSum&& later) {
+            addValue(later.sum);
+            overflowed = overflowed || later.overflowed;
+            negatives.insert(negatives.end(), later.negatives.begin(), later.negatives.end());
+        }
+    };
+
+    // Strips a "//...\n" header from numbers and returns the delimiters to use
+    static const DelimiterSet& delimitersFor(std::string_view& numbers) {
+        if (numbers.substr(0, 2) != "//") {
+            return DEFAULT_DELIMITERS;
+        }
+
+        size_t newline = numbers.find('\n');
+        if (newline == std::string_view::npos) {
+            throw std::invalid_argument("Delimiter header must end with a newline");
+        }
+        std::string_view header = numbers.substr(2, newline - 2);
+        numbers.remove_prefix(newline + 1);
+        return compileHeader(header);
+    }
+
+    // The most recent header and its compiled delimiters, reused while the
+    // same header keeps arriving. The cache is per thread, so one calculator
+    // can be shared between threads.
+    static const DelimiterSet& compileHeader(std::string_view header) {
+        thread_local std::string cachedHeader;
+        thread_local std::unique_ptr<DelimiterSet> cachedDelimiters;
+        if (!cachedDelimiters || header != cachedHeader) {
+            cachedDelimiters = std::make_unique<DelimiterSet>(DelimiterSet::fromHeader(header));
+            cachedHeader.assign(header);
+        }
+        return *cachedDelimiters;
+    }
+
+    static void accumulate(std::string_view numbers, const DelimiterSet& delimiters, PartialSum& partial) {
+        const char* position = numbers.data();
+        const char* end = position + numbers.size();
+        while (position < end) {
+            while (position < end && isBlank(*position)) {
+                ++position;
+            }
+            if (position + 1 < end && *position == '+' && isDigit(position[1])) {
+                ++position;
+            }
+
+            // Fast path for the common case: a short run of plain digits
+            if (position < end && isDigit(*position)) {
+                const char* digitsEnd = position;
+                int64_t value = 0;
+                while (digitsEnd < end && isDigit(*digitsEnd) && digitsEnd - position < 9) {
+                    value = value * 10 + (*digitsEnd - '0');
+                    ++digitsEnd;
+                }
+                size_t delimiterLength = digitsEnd == end ? 0 : delimiters.matchAt(digitsEnd, end);
+                if (digitsEnd == end || delimiterLength > 0) {
+                    partial.addValue(value);
+                    position = digitsEnd + delimiterLength;
+                    continue;
+                }
+            }
+
+            int number = 0;
+            auto [next, error] = std::from_chars(position, end, number);
+            if (error == std::errc()) {
+                if (number < 0) {
+                    partial.negatives.push_back(number);
+                } else {
+                    partial.addValue(number);
+                }
+                position = next;
+            } else if (error == std::errc::result_out_of_range) {
+                throw std::out_of_range("Number out of range");
+            }
+
+            while (position < end) {
+                size_t delimiterLength = delimiters.matchAt(position, end);
+                if (delimiterLength > 0) {
+                    position += delimiterLength;
+                    break;
+                }
+                ++position; // skip the rest of the token
+            }
+        }
+    }
+
+    // Where a chunk can be cut without changing how it parses: just after the
+    // last ',' or newline, or after the last delimiter that follows a digit.
+    // No delimiter contains a digit, so parsing always reaches that delimiter
+    // and matches it the same way; it must lie wholly inside the chunk, with
+    // room for the longest delimiter, so a longer match cannot straddle the cut.
+    static size_t lastSafeCut(const std::string& chunk, const DelimiterSet& delimiters) {
+        const char* data = chunk.data();
+        const char* end = data + chunk.size();
+        size_t longest = delimiters.getLongestLength();
+        for (size_t i = chunk.size(); i-- > 0;) {
+            if (data[i] == ',' || data[i] == '\n') {
+                return i + 1;
+            }
+            if (i > 0 && isDigit(data[i - 1]) && i + longest <= chunk.size()) {
+                if (size_t length = delimiters.matchAt(data + i, end)) {
+                    return i + length;
+                }
+            }
+        }
+        return std::string::npos;
+    }
+
+    // Reads up to count chunks of about chunkBytes, each cut at its last safe
+    // point; the unfinished token is carried into the next chunk
+    static std::vector<std::string> readChunks(std::istream& input, const DelimiterSet& delimiters, std::string& carry,
+                                               size_t count, size_t chunkBytes) {
+        std::vector<std::string> chunks;
+        while (chunks.size() < count && (input || !carry.empty())) {
+            std::string chunk = std::move(carry);
+            carry.clear();
+            size_t kept = chunk.size();
+            chunk.resize(kept + chunkBytes);
+            input.read(&chunk[kept], static_cast<std::streamsize>(chunkBytes));
+            chunk.resize(kept + static_cast<size_t>(input.gcount()));
+
+            if (!input) {
+                if (!chunk.empty()) {
+                    chunks.push_back(std::move(chunk));
+                }
+                break;
+            }
+
+            size_t cut = lastSafeCut(chunk, delimiters);
+            if (cut == std::string::npos) {
+                carry = std::move(chunk); // one token longer than a chunk
+                continue;
+            }
+            carry.assign(chunk, cut, std::string::npos);
+            chunk.resize(cut);
+            chunks.push_back(std::move(chunk));
+        }
+        return chunks;
+    }
+
+public:
+    int add(std::string_view numbers) const {
+        const DelimiterSet& delimiters = delimitersFor(numbers);
+        PartialSum partial;
+        accumulate(numbers, delimiters, partial);
+
+        if (!partial.negatives.empty()) {
+            throwNegatives(partial.negatives);
+        }
+        if (partial.overflowed || partial.sum > INT_MAX) {
+            throw std::overflow_error("Sum exceeds int range");
+        }
+        return static_cast<int>(partial.sum);
+    }
+
+    // Stream mode for inputs too large to hold in memory. Chunks are parsed on
+    // worker threads while the next batch is read, and partial sums are merged
+    // in input order, so results (including the negatives list) are identical
+    // to add() on the whole input
+    long long addStream(std::istream& input, size_t threadCount = std::thread::hardware_concurrency(),
+                        size_t chunkBytes = 4 * 1024 * 1024) const {
+        threadCount = std::max<size_t>(threadCount, 1);
+        PartialSum total;
+        std::string carry;
+
+        const DelimiterSet* delimiters = &DEFAULT_DELIMITERS;
+        std::optional<DelimiterSet> custom;
+        if (input.peek() == '/') {
+            input.get();
+            if (input.peek() == '/') {
+                input.get();
+                std::string header;
+                if (!std::getline(input, header) || input.eof()) {
+                    throw std::invalid_argument("Delimiter header must end with a newline");
+                }
+                delimiters = &custom.emplace(DelimiterSet::fromHeader(header));
+            } else {
+                input.unget();
+            }
+        }
+
+        std::vector<std::string> batch = readChunks(input, *delimiters, carry, threadCount, chunkBytes);
+        while (!batch.empty()) {
+            std::vector<std::future<PartialSum>> parsing;
+            for (const auto& chunk : batch) {
+                parsing.push_back(std::async(std::launch::async, [&chunk, delimiters]() {
+                    PartialSum partial;
+                    accumulate(chunk, *delimiters, partial);
+                    return partial;
+                }));
+            }
+
+            std::vector<std::string> nextBatch = readChunks(input, *delimiters, carry, threadCount, chunkBytes);
+            for (auto& result : parsing) {
+                total.merge(result.get());
+            }
+            batch = std::move(nextBatch);
+        }
+
+        if (!total.negatives.empty()) {
+            throwNegatives(total.negatives);
+        }
+        if (total.overflowed) {
+            throw std::overflow_error("Sum exceeds 64-bit range");
+        }
+        return total.sum;
+    }
+
+    long long addFile(const std::string& path, size_t threadCount = std::thread::hardware_concurrency()) const {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Cannot open input file: " + path);
+        }
+        return addStream(input, threadCount);
+    }
+
+    // Original copy + stringstream + stoi implementation, kept as the
+    // reference for tests and benchmarks
+    int addReference(const std::string& numbers) {
+        if (numbers.empty()) {
+            return 0;
+        }
+
+        std::vector<int> parsedNumbers;
+        std::vector<int> negatives;
+
+        // Replace newlines with commas for uniform parsing
+        std::string normalizedNumbers = numbers;
+        std::replace(normalizedNumbers.begin(), normalizedNumbers.end(), '\n', ',');
+
+        std::stringstream ss(normalizedNumbers);
+        std::string numberString;
+
+        while (std::getline(ss, numberString, ',')) {
+            if (!numberString.empty()) {
+                try {
+                    int number = std::stoi(numberString);
+                    if (number < 0) {
+                        negatives.push_back(number);
+                    } else {
+                        parsedNumbers.push_back(number);
+                    }
+                } catch (const std::invalid_argument&) {
+                    // Ignore invalid numbers
+                }
+            }
+        }
+
+        if (!negatives.empty()) {
+            std::string errorMessage = "Negatives not allowed: ";
+            for (size_t i = 0; i < negatives.size(); ++i) {
+                if (i > 0) errorMessage += ", ";
+                errorMessage += std::to_string(negatives[i]);
+            }
+            throw std::runtime_error(errorMessage);
+        }
+
+        return std::accumulate(parsedNumbers.begin(), parsedNumbers.end(), 0);
+    }
+};
+
+const DelimiterSet StringCalculator::DEFAULT_DELIMITERS;
+
+// Simple Test Framework for C++
+// Optimization barriers for microbenchmarks: doNotOptimize makes the compiler
+// treat a value as used, clobberMemory makes it assume all memory was touched
+namespace Bench {
+#if defined(__GNUC__) || defined(__clang__)
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+            asm volatile("" : : "r,m"(value) : "memory");
+        } else {
+            asm volatile("" : : "m"(value) : "memory");
+        }
+    }
+
+    // Read-write barrier: the compiler must assume value changed, so work
+    // that depends on it cannot be hoisted out of a timed loop
+    template<typename T>
+    inline void doNotOptimize(T& value) {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+            asm volatile("" : "+r,m"(value) : : "memory");
+        } else {
+            asm volatile("" : "+m"(value) : : "memory");
+        }
+    }
+
+    inline void clobberMemory() {
+        asm volatile("" : : : "memory");
+    }
+#else
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+        static volatile const void* sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    template<typename T>
+    inline void doNotOptimize(T& value) {
+        static volatile void* sink;
+        sink = &value;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    inline void clobberMemory() {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+#endif
+}
+
+struct BenchmarkConfig {
+    std::chrono::milliseconds warmup{20};
+    std::chrono::microseconds minSampleTime{500};
+    size_t sampleCount = 100;
+};
+
+// Property-based testing: random inputs from a generator, and on failure a
+// greedy shrink towards the smallest input that still fails
+struct PropertyConfig {
+    size_t maxCases = 10000000;
+    std::chrono::milliseconds timeBudget{250};
+    uint64_t seed = 0x5eed15;
+    size_t maxShrinkSteps = 2000;
+};
+
+namespace Shrink {
+    // Smaller versions of a string or vector: drop halves, quarters, ... of it,
+    // then single elements
+    template<typename Sequence>
+    std::vector<Sequence> removals(const Sequence& input) {
+        std::vector<Sequence> candidates;
+        for (size_t chunk = input.size() / 2; chunk >= 1; chunk /= 2) {
+            for (size_t start = 0; start + chunk <= input.size(); start += chunk) {
+                Sequence smaller(input.begin(), input.begin() + start);
+                smaller.insert(smaller.end(), input.begin() + start + chunk, input.end());
+                candidates.push_back(std::move(smaller));
+            }
+        }
+        return candidates;
+    }
+
+    // Removals, then each character replaced by a simpler one
+    inline std::vector<std::string> string(const std::string& input, const std::string& simplerCharacters) {
+        std::vector<std::string> candidates = removals(input);
+        for (size_t i = 0; i < input.size(); ++i) {
+            for (char simpler : simplerCharacters) {
+                if (simpler < input[i] || simplerCharacters.find(input[i]) == std::string::npos) {
+                    std::string candidate = input;
+                    candidate[i] = simpler;
+                    candidates.push_back(std::move(candidate));
+                    break;
+                }
+            }
+        }
+        return candidates;
+    }
+
+    inline std::string quote(const std::string& input) {
+        std::string quoted = "\"";
+        for (char c : input) {
+            if (c == '\n') {
+                quoted += "\\n";
+            } else if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            } else if (static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x7f) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\x%02x", static_cast<unsigned char>(c));
+                quoted += escape;
+            } else {
+                quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+}
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterationsPerSample = 0;
+    size_t samples = 0;
+    double minNs = 0.0;     // per iteration
+    double medianNs = 0.0;
+    double p99Ns = 0.0;
+};
+
+class SimpleTestRunner {
+private:
+    struct RegisteredTest {
+        std::string group;
+        std::string name;
+        std::function<void(SimpleTestRunner&)> body;
+    };
+
+    struct TestTiming {
+        std::string name;
+        double milliseconds;
+    };
+
+    std::atomic<int> testsPassed{0};
+    std::atomic<int> testsFailed{0};
+    std::ostream& output;
+    std::mutex outputMutex;
+    std::vector<RegisteredTest> registeredTests;
+    std::vector<TestTiming> timings;
+    BenchmarkConfig benchmarkConfig;
+    PropertyConfig propertyConfig;
+    std::vector<BenchmarkResult> benchmarkResults;
+
+    template<typename Func>
+    static double timeIterations(Func& func, uint64_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            func();
+        }
+        Bench::clobberMemory();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static std::string escapeJson(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+                escaped += escape;
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    void report(const std::string& line) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        output << line << std::endl;
+    }
+
+    void pass(const std::string& testName) {
+        testsPassed.fetch_add(1, std::memory_order_relaxed);
+        report("✅ " + testName);
+    }
+
+    void fail(const std::string& message) {
+        testsFailed.fetch_add(1, std::memory_order_relaxed);
+        report("❌ " + message);
+    }
+
+public:
+    explicit SimpleTestRunner(std::ostream& output = std::cout) : output(output) {}
+
+    SimpleTestRunner(const SimpleTestRunner&) = delete;
+    SimpleTestRunner& operator=(const SimpleTestRunner&) = delete;
+
+    void assertTrue(bool condition, const std::string& testName) {
+        if (condition) {
+            pass(testName);
+        } else {
+            fail(testName);
+        }
+    }
+
+    template<typename T>
+    void assertEqual(const T& expected, const T& actual, const std::string& testName) {
+        if (expected == actual) {
+            pass(testName);
+        } else {
+            std::ostringstream message;
+            message << testName << " - Expected: " << expected << ", Actual: " << actual;
+            fail(message.str());
+        }
+    }
+
+    template<typename ExceptionType, typename Func>
+    void assertThrows(Func&& func, const std::string& testName) {
+        try {
+            func();
+            fail(testName + " - Expected exception was not thrown");
+        } catch (const ExceptionType&) {
+            pass(testName);
+        } catch (const std::exception& ex) {
+            fail(testName + " - Wrong exception type: " + ex.what());
+        }
+    }
+
+    // Test registration: tests in the same group are printed under one heading
+    void registerTest(const std::string& group, const std::string& name,
+                      std::function<void(SimpleTestRunner&)> body) {
+        registeredTests.push_back({group, name, std::move(body)});
+    }
+
+    // Runs every registered test function on a work-stealing pool. Each test
+    // reports into its own buffer, which is printed in registration order once
+    // all tests finish, so the output does not depend on scheduling.
+    void runAll(size_t threadCount = std::thread::hardware_concurrency()) {
+        struct Outcome {
+            std::ostringstream text;
+            int passed = 0;
+            int failed = 0;
+            double milliseconds = 0.0;
+        };
+        std::vector<Outcome> outcomes(registeredTests.size());
+        WorkStealingPool pool(threadCount);
+
+        auto runStart = std::chrono::steady_clock::now();
+        pool.run(registeredTests.size(), [&](size_t index) {
+            Outcome& outcome = outcomes[index];
+            SimpleTestRunner testRunner(outcome.text);
+            testRunner.benchmarkConfig = benchmarkConfig;
+            testRunner.propertyConfig = propertyConfig;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                registeredTests[index].body(testRunner);
+            } catch (const std::exception& ex) {
+                testRunner.fail(registeredTests[index].name + " - Unexpected exception: " + ex.what());
+            } catch (...) {
+                testRunner.fail(registeredTests[index].name + " - Unexpected non-standard exception");
+            }
+            outcome.milliseconds = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            outcome.passed = testRunner.testsPassed.load();
+            outcome.failed = testRunner.testsFailed.load();
+        });
+        double wallMilliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - runStart).count();
+
+        double totalMilliseconds = 0.0;
+        const std::string* currentGroup = nullptr;
+        for (size_t i = 0; i < registeredTests.size(); ++i) {
+            if (!currentGroup || *currentGroup != registeredTests[i].group) {
+                currentGroup = &registeredTests[i].group;
+                output << (i == 0 ? "" : "\n") << "--- " << *currentGroup << " ---" << std::endl;
+            }
+            output << outcomes[i].text.str();
+            testsPassed += outcomes[i].passed;
+            testsFailed += outcomes[i].failed;
+            timings.push_back({registeredTests[i].name, outcomes[i].milliseconds});
+            totalMilliseconds += outcomes[i].milliseconds;
+        }
+        registeredTests.clear();
+
+        output << "\nRan " << outcomes.size() << " test functions on " << pool.getThreadCount()
+               << (pool.getThreadCount() == 1 ? " thread in " : " threads in ") << std::fixed << std::setprecision(1) << wallMilliseconds
+               << " ms (" << totalMilliseconds << " ms of test time)" << std::endl;
+    }
+
+    // Allocation gate: fails if func makes more than maxAllocations heap
+    // allocations on the calling thread
+    template<typename Func>
+    void assertMaxAllocations(size_t maxAllocations, Func&& func, const std::string& testName) {
+        size_t allocations = AllocationCounter::countAllocations(func);
+        if (allocations <= maxAllocations) {
+            pass(testName);
+        } else {
+            fail(testName + " - Expected at most " + std::to_string(maxAllocations) +
+                 " allocations, made " + std::to_string(allocations));
+        }
+    }
+
+    // The still-escaped name of a benchmark line from writeBenchmarkJson, which
+    // always starts its object with the name key
+    static std::optional<std::string_view> benchmarkNameOf(std::string_view line) {
+        const std::string_view prefix = "{\"name\": \"";
+        size_t start = line.find('{');
+        if (start == std::string_view::npos || line.substr(start, prefix.size()) != prefix) {
+            return std::nullopt;
+        }
+        start += prefix.size();
+        for (size_t i = start; i < line.size(); ++i) {
+            if (line[i] == '\\') {
+                ++i;
+            } else if (line[i] == '"') {
+                return line.substr(start, i - start);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Reads the median of one benchmark from a file written by writeBenchmarkJson;
+    // nullopt when no entry has exactly that name. A missing or unreadable
+    // file, or an entry without a median, throws.
+    static std::optional<double> readBaselineMedian(const std::string& baselineFile, const std::string& name) {
+        std::ifstream file(baselineFile);
+        if (!file) {
+            throw std::runtime_error("Cannot open baseline file: " + baselineFile);
+        }
+        const std::string escapedName = escapeJson(name);
+        const std::string medianKey = ", \"median_ns\": ";
+        std::string line;
+        while (std::getline(file, line)) {
+            std::optional<std::string_view> lineName = benchmarkNameOf(line);
+            if (!lineName || *lineName != escapedName) {
+                continue;
+            }
+            size_t nameEnd = static_cast<size_t>(lineName->data() - line.data()) + lineName->size();
+            size_t median = line.find(medianKey, nameEnd);
+            if (median == std::string::npos) {
+                throw std::runtime_error("Baseline entry for " + name + " has no median_ns");
+            }
+            return std::strtod(line.c_str() + median + medianKey.size(), nullptr);
+        }
+        if (file.bad()) {
+            throw std::runtime_error("Cannot read baseline file: " + baselineFile);
+        }
+        return std::nullopt;
+    }
+
+    // Performance gate: benchmarks func and fails if its median is more than
+    // tolerance (a fraction, 0.25 = 25%) slower than the stored baseline.
+    // A benchmark missing from the baseline fails too, so a renamed benchmark
+    // or a typo cannot switch its gate off; refresh the baseline with
+    // --benchmark-json after adding a gate. Gate timings are not added to the
+    // results written by writeBenchmarkJson.
+    template<typename Func>
+    void assertFasterThan(const std::string& baselineFile, const std::string& name, Func&& func, double tolerance) {
+        std::optional<double> baseline;
+        try {
+            baseline = readBaselineMedian(baselineFile, name);
+        } catch (const std::exception& ex) {
+            fail("Performance of " + name + " - " + ex.what());
+            return;
+        }
+        if (!baseline) {
+            fail("Performance of " + name + " - no entry in baseline file " + baselineFile);
+            return;
+        }
+        double median = measure(name, std::forward<Func>(func)).medianNs;
+
+        std::ostringstream message;
+        message << std::fixed << std::setprecision(1) << "Performance of " << name << ": " << median << " ns";
+        message << " vs baseline " << *baseline << " ns";
+        if (median <= *baseline * (1.0 + tolerance)) {
+            pass(message.str());
+        } else {
+            message << " - more than " << tolerance * 100.0 << "% slower";
+            fail(message.str());
+        }
+    }
+
+    void configureProperties(const PropertyConfig& config) {
+        propertyConfig = config;
+    }
+
+    // Property check: feeds generated inputs to holds() until maxCases or the
+    // time budget runs out. A failing input is shrunk by repeatedly taking the
+    // first shrink() candidate that still fails, and reported with describe().
+    template<typename Generate, typename Holds, typename ShrinkInput, typename Describe>
+    void checkProperty(const std::string& name, Generate generate, Holds holds, ShrinkInput shrink, Describe describe) {
+        using Input = std::decay_t<std::invoke_result_t<Generate&, std::mt19937_64&>>;
+        using Clock = std::chrono::steady_clock;
+
+        std::mt19937_64 random(propertyConfig.seed);
+        auto start = Clock::now();
+        auto deadline = start + propertyConfig.timeBudget;
+        size_t cases = 0;
+        while (cases < propertyConfig.maxCases) {
+            if (cases % 256 == 0 && Clock::now() >= deadline) {
+                break;
+            }
+            Input input = generate(random);
+            ++cases;
+            if (holds(input)) {
+                continue;
+            }
+
+            size_t steps = 0;
+            bool shrunk = true;
+            while (shrunk && steps < propertyConfig.maxShrinkSteps) {
+                shrunk = false;
+                for (Input& candidate : shrink(input)) {
+                    if (++steps > propertyConfig.maxShrinkSteps) {
+                        break;
+                    }
+                    if (!holds(candidate)) {
+                        input = std::move(candidate);
+                        shrunk = true;
+                        break;
+                    }
+                }
+            }
+            fail(name + " - falsified after " + std::to_string(cases) + " cases (seed " +
+                 std::to_string(propertyConfig.seed) + "), shrunk to " + describe(input));
+            return;
+        }
+
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::ostringstream message;
+        message << name << " - " << cases << " cases, " << std::fixed << std::setprecision(0)
+                << (seconds > 0 ? cases / seconds : 0.0) << " cases/s";
+        pass(message.str());
+    }
+
+    void configureBenchmarks(const BenchmarkConfig& config) {
+        benchmarkConfig = config;
+    }
+
+    // Microbenchmark: warms func up, doubles the iteration count until one
+    // sample takes at least minSampleTime, then times sampleCount samples and
+    // reports per-iteration min, median and p99. func should pass its result
+    // to Bench::doNotOptimize so the work is not optimized away.
+    template<typename Func>
+    BenchmarkResult benchmark(const std::string& name, Func func) {
+        BenchmarkResult result = measure(name, func);
+        benchmarkResults.push_back(result);
+        return result;
+    }
+
+    // Runs and reports a benchmark without recording it in the results
+    template<typename Func>
+    BenchmarkResult measure(const std::string& name, Func func) {
+        using Clock = std::chrono::steady_clock;
+        auto warmupEnd = Clock::now() + benchmarkConfig.warmup;
+        do {
+            func();
+        } while (Clock::now() < warmupEnd);
+
+        const double minSampleNs = std::chrono::duration<double, std::nano>(benchmarkConfig.minSampleTime).count();
+        uint64_t iterations = 1;
+        while (timeIterations(func, iterations) < minSampleNs && iterations < (uint64_t{1} << 40)) {
+            iterations *= 2;
+        }
+
+        std::vector<double> perIteration(std::max<size_t>(1, benchmarkConfig.sampleCount));
+        for (double& sample : perIteration) {
+            sample = timeIterations(func, iterations) / static_cast<double>(iterations);
+        }
+        std::sort(perIteration.begin(), perIteration.end());
+        auto percentile = [&](double fraction) {
+            size_t rank = static_cast<size_t>(std::ceil(fraction * perIteration.size()));
+            return perIteration[std::max<size_t>(1, rank) - 1];
+        };
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterationsPerSample = iterations;
+        result.samples = perIteration.size();
+        result.minNs = perIteration.front();
+        result.medianNs = percentile(0.50);
+        result.p99Ns = percentile(0.99);
+
+        std::ostringstream line;
+        line << "⏱  " << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+             << " min " << std::setw(9) << result.minNs << " ns"
+             << "  median " << std::setw(9) << result.medianNs << " ns"
+             << "  p99 " << std::setw(9) << result.p99Ns << " ns"
+             << "  (" << result.samples << " x " << iterations << " iterations)";
+        report(line.str());
+        return result;
+    }
+
+    const std::vector<BenchmarkResult>& getBenchmarkResults() const {
+        return benchmarkResults;
+    }
+
+    void writeBenchmarkJson(std::ostream& json) const {
+        json << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < benchmarkResults.size(); ++i) {
+            const BenchmarkResult& result = benchmarkResults[i];
+            json << (i == 0 ? "\n" : ",\n") << std::fixed << std::setprecision(2)
+                 << "    {\"name\": \"" << escapeJson(result.name) << "\""
+                 << ", \"iterations\": " << result.iterationsPerSample
+                 << ", \"samples\": " << result.samples
+                 << ", \"min_ns\": " << result.minNs
+                 << ", \"median_ns\": " << result.medianNs
+                 << ", \"p99_ns\": " << result.p99Ns << "}";
+        }
+        json << "\n  ]\n}\n";
+    }
+
+    void printSlowestTests(size_t count = 5) {
+        std::vector<TestTiming> slowest = timings;
+        std::sort(slowest.begin(), slowest.end(), [](const TestTiming& a, const TestTiming& b) {
+            return a.milliseconds > b.milliseconds;
+        });
+        slowest.resize(std::min(count, slowest.size()));
+
+        output << "\n=== Slowest Tests ===" << std::endl;
+        for (const auto& timing : slowest) {
+            output << std::fixed << std::setprecision(1) << std::setw(9) << timing.milliseconds
+                   << " ms  " << timing.name << std::endl;
+        }
+    }
+
+    int getFailedCount() const {
+        return testsFailed.load();
+    }
+
+    void printSummary() {
+        int passed = testsPassed.load();
+        int failed = testsFailed.load();
+        int total = passed + failed;
+        double successRate = total > 0 ? (passed * 100.0 / total) : 0.0;
+
+        output << "\n=== Test Summary ===" << std::endl;
+        output << "Passed: " << passed << std::endl;
+        output << "Failed: " << failed << std::endl;
+        output << "Total: " << total << std::endl;
+        output << "Success Rate: " << std::fixed << std::setprecision(1) << successRate << "%" << std::endl;
+    }
+};
+
+// Temp-file path unique to this process and call, so overlapping runs never share files
+std::string uniqueTempPath(const std::string& stem) {
+    static std::atomic<unsigned> counter{0};
+    std::random_device entropy;
+    std::string name = stem + "-" + std::to_string(entropy()) + "-" + std::to_string(counter++);
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Test Functions
+void testCalculator(SimpleTestRunner& runner) {
+    Calculator calculator;
+
+    runner.assertEqual(8.0, calculator.add(5, 3), "Add two positive numbers");
+    runner.assertEqual(2.0, calculator.subtract(5, 3), "Subtract two numbers");
+    runner.assertEqual(15.0, calculator.multiply(5, 3), "Multiply two numbers");
+    runner.assertEqual(2.0, calculator.divide(6, 3), "Divide two numbers");
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        calculator.divide(5, 0);
+    }, "Divide by zero throws exception");
+
+    std::vector<double> numbers = {1.0, 2.0, 3.0, 4.0};
+    runner.assertEqual(10.0, calculator.calculateTotal(numbers), "Calculate total of array");
+
+    DivisionResult quotient = calculator.tryDivide(6, 3);
+    runner.assertTrue(quotient.hasValue() && quotient.value == 2.0, "tryDivide returns quotient");
+    DivisionResult byZero = calculator.tryDivide(5, 0);
+    runner.assertTrue(!byZero && byZero.error == CalculationError::DIVIDE_BY_ZERO && std::isnan(byZero.value),
+        "tryDivide reports divide by zero without throwing");
+    runner.assertEqual(-1.0, byZero.valueOr(-1.0), "valueOr substitutes a fallback for failed division");
+
+    // Every instruction set this CPU has must agree with the scalar kernels,
+    // including the tails that do not fill a whole vector
+    const size_t count = 1003;
+    std::vector<double> a(count), b(count);
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = static_cast<double>(i) * 0.5 - 100.0;
+        b[i] = i % 97 == 0 ? 0.0 : static_cast<double>(i % 13) - 6.5;
+    }
+    Calculator scalar(SimdLevel::SCALAR);
+    std::vector<double> expected(count), actual(count);
+    std::vector<size_t> expectedZeros;
+    scalar.divide(a, b, expected, &expectedZeros);
+
+    for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level > detectSimdLevel()) {
+            continue;
+        }
+        Calculator bulk(level);
+        const std::string name = simdLevelName(level);
+        bool matches = true;
+        bulk.add(a, b, actual);
+        for (size_t i = 0; i < count; ++i) matches &= actual[i] == a[i] + b[i];
+        bulk.subtract(a, b, actual);
+        for (size_t i = 0; i < count; ++i) matches &= actual[i] == a[i] - b[i];
+        bulk.multiply(a, b, actual);
+        for (size_t i = 0; i < count; ++i) matches &= actual[i] == a[i] * b[i];
+        runner.assertTrue(matches, name + " bulk add/subtract/multiply match scalar operations");
+
+        std::vector<size_t> zeros;
+        size_t zeroCount = bulk.divide(a, b, actual, &zeros);
+        bool divideMatches = zeroCount == expectedZeros.size() && zeros == expectedZeros;
+        for (size_t i = 0; i < count; ++i) {
+            divideMatches &= b[i] == 0.0 ? std::isnan(actual[i]) : actual[i] == expected[i];
+        }
+        runner.assertTrue(divideMatches, name + " bulk divide reports zero divisors per element");
+
+        runner.assertTrue(std::abs(bulk.calculateTotal(a) - std::accumulate(a.begin(), a.end(), 0.0)) < 1e-6,
+            name + " multi-accumulator total matches sequential sum");
+    }
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        std::vector<double> shorter(count - 1);
+        calculator.add(a, b, shorter);
+    }, "Bulk operands of different lengths throw exception");
+}
+
+void testShoppingCart(SimpleTestRunner& runner) {
+    ShoppingCart cart;
+
+    runner.assertEqual(static_cast<size_t>(0), cart.getItemTypes(), "New cart is empty");
+    runner.assertEqual(0.0, cart.getTotal(), "Empty cart total is zero");
+
+    cart.addItem("Apple", 1.50, 2);
+    runner.assertEqual(static_cast<size_t>(1), cart.getItemTypes(), "Cart has one item type");
+    runner.assertEqual(3.00, cart.getTotal(), "Cart total with one item");
+    runner.assertEqual(2, cart.getItemCount(), "Cart item count");
+
+    cart.addItem("Banana", 0.75, 3);
+    runner.assertEqual(5.25, cart.getTotal(), "Cart total with multiple items");
+
+    runner.assertTrue(cart.hasItem("Apple"), "Cart contains added item");
+    runner.assertTrue(!cart.hasItem("Orange"), "Cart doesn't contain non-added item");
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        cart.addItem("Invalid", -1.0);
+    }, "Negative price throws exception");
+
+    cart.addItem("Cherry", 2.00, 1);
+    cart.addItem("Apple", 1.00, 1);
+    runner.assertTrue(cart.removeItem("Apple"), "Remove existing item");
+    runner.assertTrue(cart.hasItem("Apple"), "Duplicate name still present after one remove");
+    runner.assertTrue(cart.removeItem("Banana"), "Remove item from middle of cart");
+    runner.assertTrue(cart.hasItem("Cherry"), "Moved item still found after swap-and-pop");
+    runner.assertTrue(!cart.removeItem("Orange"), "Removing missing item returns false");
+    runner.assertEqual(2, cart.getItemCount(), "Item count updated by removals");
+    runner.assertEqual(3.00, cart.getTotal(), "Removing a duplicate name drops the first line added");
+
+    cart.removeItem("Apple");
+    cart.removeItem("Cherry");
+    runner.assertEqual(static_cast<size_t>(0), cart.getItemTypes(), "Cart empty after removing everything");
+    runner.assertEqual(0.0, cart.getTotal(), "Total is zero after removing everything");
+
+    ShoppingCart churn;
+    churn.addItem("Anchor", 0.10, 1);
+    for (int i = 0; i < 1000; ++i) {
+        churn.addItem("Gum", 0.10, 3);
+        churn.addItem("Mint", 0.70, 1);
+        churn.removeItem("Gum");
+        churn.removeItem("Mint");
+    }
+    runner.assertEqual(0.10, churn.getTotal(), "Total does not drift over add/remove cycles");
+
+    ShoppingCart repeats;
+    repeats.addItem("Tea", 1.00, 1);
+    repeats.addItem("Cake", 5.00, 1);
+    repeats.addItem("Tea", 2.00, 1);
+    repeats.addItem("Tea", 4.00, 1);
+    repeats.removeItem("Cake"); // moves the last Tea line into Cake's slot
+    bool removedAll = true;
+    runner.assertMaxAllocations(0, [&]() { removedAll = repeats.removeItem("Tea"); }, "Removing a line does not allocate");
+    runner.assertEqual(6.00, repeats.getTotal(), "Moved line keeps its place in its name's order");
+    removedAll = removedAll && repeats.removeItem("Tea");
+    runner.assertEqual(4.00, repeats.getTotal(), "Lines sharing a name are removed oldest first");
+    removedAll = removedAll && repeats.removeItem("Tea");
+    runner.assertTrue(removedAll && !repeats.hasItem("Tea") && repeats.getItemTypes() == 0,
+        "Last line of a name empties its list");
+
+    alignas(std::max_align_t) char arena[2048];
+    std::pmr::monotonic_buffer_resource bounded(arena, sizeof(arena), std::pmr::null_memory_resource());
+    ShoppingCart tight(&bounded);
+    int added = 0;
+    std::string failedName;
+    try {
+        for (;; ++added) {
+            failedName = "Item number " + std::to_string(added) + " with a name too long for SSO";
+            tight.addItem(failedName, 1.00, 1);
+        }
+    } catch (const std::bad_alloc&) {
+    }
+    runner.assertTrue(added > 0 && tight.getItemTypes() == static_cast<size_t>(added) &&
+                      tight.getItemCount() == added && !tight.hasItem(failedName),
+        "Failed add leaves the cart unchanged");
+
+    cart.addItem("Apple", 1.50, 2);
+    cart.clear();
+    runner.assertTrue(!cart.hasItem("Apple"), "Cleared cart no longer has interned name");
+    cart.addItem("Apple", 1.50, 2);
+    runner.assertEqual(3.00, cart.getTotal(), "Refilled cart reuses interned name");
+
+    double total = 0.0;
+    runner.assertMaxAllocations(0, [&]() {
+        total = cart.getTotal() + cart.getItemCount();
+        total += cart.hasItem("Apple");
+    }, "Reading totals and looking up items does not allocate");
+}
+
+void testConcurrentShoppingCart(SimpleTestRunner& runner) {
+    ConcurrentShoppingCart cart;
+    const int threadCount = 4;
+    const int itemsPerThread = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&cart, t]() {
+            for (int i = 0; i < itemsPerThread; ++i) {
+                cart.addItem("Item" + std::to_string(t), 0.10, 2);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    runner.assertEqual(threadCount * itemsPerThread * 2, cart.getItemCount(), "Concurrent adds keep exact item count");
+    runner.assertEqual(800.0, cart.getTotal(), "Concurrent adds keep exact cents total");
+
+    CartSnapshot snapshot = cart.snapshot();
+    runner.assertEqual(static_cast<size_t>(threadCount * itemsPerThread), snapshot.items.size(), "Snapshot holds every item");
+    runner.assertEqual(800.0, snapshot.getTotal(), "Snapshot total matches items");
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        cart.addItem("Invalid", -1.0);
+    }, "Concurrent cart rejects negative price");
+}
+
+void testPasswordValidator(SimpleTestRunner& runner) {
+    PasswordValidator validator;
+
+    auto result = validator.validatePassword("short");
+    runner.assertTrue(!result.isValid(), "Short password is invalid");
+
+    result = validator.validatePassword("password123");
+    runner.assertTrue(!result.isValid(), "Password without uppercase is invalid");
+
+    result = validator.validatePassword("Password123!");
+    runner.assertTrue(result.isValid(), "Valid password passes validation");
+
+    result = validator.validatePassword("password");
+    runner.assertTrue(!result.isValid(), "Common password is invalid");
+
+    result = validator.validatePassword("QWERTY");
+    runner.assertTrue(result.toString().find("too common") != std::string::npos, "Common password match ignores case");
+
+    bool matchesReference = true;
+    for (const std::string password : {"", "short", "PASSWORD", "password123", "Password123!", "NoDigits!!",
+                                       "nouppercase1!", "ALLUPPER1!", "Abcdefg1*", "caf\xc3\xa9Latte1!"}) {
+        if (validator.validatePassword(password).toString() != validator.validatePasswordReference(password).toString()) {
+            matchesReference = false;
+        }
+    }
+    runner.assertTrue(matchesReference, "Single-pass validation matches reference implementation");
+
+    result = validator.validatePassword("short");
+    runner.assertTrue(result.hasError(ValidationError::TOO_SHORT) && !result.hasError(ValidationError::MISSING_LOWERCASE),
+        "Result records which rules failed");
+    runner.assertEqual(static_cast<size_t>(4), result.getErrorCount(), "Result counts failed rules");
+    runner.assertEqual(std::string("Password must be at least 8 characters long"), result.getErrors()[0],
+        "Error messages rendered on demand");
+
+    const std::string validPassword = "Password123!";
+    const std::string invalidPassword = "weak";
+    runner.assertMaxAllocations(0, [&]() {
+        result = validator.validatePassword(validPassword);
+    }, "Validating a good password does not allocate");
+    runner.assertMaxAllocations(0, [&]() {
+        result = validator.validatePassword(invalidPassword);
+    }, "Rejecting a bad password does not allocate");
+
+    auto batch = validator.validatePasswords({"Password123!", "short", "Abcdefg1*"});
+    runner.assertTrue(batch.size() == 3 && batch[0].isValid() && !batch[1].isValid() && batch[2].isValid(),
+        "Batch validation returns results in input order");
+}
+
+void testBreachedPasswordIndex(SimpleTestRunner& runner) {
+    std::vector<std::string> breached = {"Summer2024!", "Winter2023#", "P@ssw0rd1"};
+    for (int i = 0; i < 5000; ++i) {
+        breached.push_back("leaked" + std::to_string(i));
+    }
+    auto index = BreachedPasswordIndex::fromPasswords(breached);
+
+    runner.assertEqual(breached.size(), index.size(), "Index holds every breached password");
+    runner.assertTrue(index.contains("Summer2024!") && index.contains("leaked4999"), "Index finds breached passwords");
+
+    int falsePositives = 0;
+    for (int i = 0; i < 5000; ++i) {
+        if (index.contains("clean" + std::to_string(i))) falsePositives++;
+    }
+    runner.assertEqual(0, falsePositives, "Exact hash check rejects filter false positives");
+
+    const std::string path = uniqueTempPath("breached-passwords-test") + ".idx";
+    const std::string hashPath = path + ".hashes";
+    index.save(path, hashPath);
+
+    {
+        auto loaded = BreachedPasswordIndex::load(path, hashPath);
+        runner.assertTrue(loaded.size() == index.size() && loaded.contains("Winter2023#") && !loaded.contains("Autumn2022$"),
+            "Index survives save and load");
+#ifndef _WIN32
+        runner.assertTrue(loaded.isMemoryMapped(), "Loaded index is memory-mapped");
+#endif
+
+        auto filterOnly = BreachedPasswordIndex::load(path);
+        int filterHits = 0;
+        for (int i = 0; i < 5000; ++i) {
+            if (filterOnly.contains("clean" + std::to_string(i))) filterHits++;
+        }
+        runner.assertTrue(!filterOnly.hasExactConfirmation() && filterOnly.contains("leaked123") && filterHits < 100,
+            "Filter file works alone with a small false-positive rate");
+
+        PasswordValidator validator;
+        runner.assertTrue(validator.validatePassword("Summer2024!").isValid(), "Password valid before index is loaded");
+        validator.setBreachedPasswordIndex(std::make_shared<BreachedPasswordIndex>(std::move(loaded)));
+        runner.assertTrue(!validator.validatePassword("Summer2024!").isValid(), "Breached password rejected by validator");
+        runner.assertTrue(validator.validatePassword("Autumn2022$").isValid(), "Clean password still accepted");
+    }
+
+    // Inflate the block count in the header; load must refuse to read past the file
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t hugeCount = uint64_t(1) << 60;
+        file.seekp(2 * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char*>(&hugeCount), sizeof(hugeCount));
+    }
+    runner.assertThrows<std::runtime_error>([&]() {
+        BreachedPasswordIndex::load(path);
+    }, "Index header larger than the file throws exception");
+
+    std::filesystem::resize_file(hashPath, std::filesystem::file_size(hashPath) - 8);
+    runner.assertThrows<std::runtime_error>([&]() {
+        BreachedPasswordIndex::load(path, hashPath);
+    }, "Truncated hash file throws exception");
+    std::remove(path.c_str());
+    std::remove(hashPath.c_str());
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        BreachedPasswordIndex::load("missing-index-file.idx");
+    }, "Loading missing index throws exception");
+
+    // The --build-password-index path: a plain-text dump with CRLF lines and blanks
+    const std::string listPath = uniqueTempPath("breached-passwords-list") + ".txt";
+    {
+        std::ofstream list(listPath, std::ios::binary);
+        list << "hunter2\r\n\r\ncorrecthorse\nTr0ub4dor&3\n";
+    }
+    auto built = BreachedPasswordIndex::fromTextFile(listPath);
+    std::remove(listPath.c_str());
+    runner.assertTrue(built.size() == 3 && built.contains("hunter2") && built.contains("Tr0ub4dor&3") &&
+                      !built.contains("hunter2\r") && !built.contains(""),
+        "Index built from a text list finds every listed password");
+}
+
+void testBankAccount(SimpleTestRunner& runner) {
+    BankAccount account(100.0);
+    runner.assertEqual(100.0, account.getBalance(), "Initial balance set correctly");
+
+    account.deposit(50.0);
+    runner.assertEqual(150.0, account.getBalance(), "Balance after deposit");
+
+    account.withdraw(25.0);
+    runner.assertEqual(125.0, account.getBalance(), "Balance after withdrawal");
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        account.withdraw(200.0);
+    }, "Overdraw throws exception");
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        account.deposit(-10.0);
+    }, "Negative deposit throws exception");
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        BankAccount(-50.0);
+    }, "Negative initial balance throws exception");
+
+    runner.assertEqual(150.0, account.getTotalDeposits(), "Running deposit total");
+    runner.assertEqual(25.0, account.getTotalWithdrawals(), "Running withdrawal total");
+
+    auto history = account.getTransactionHistory();
+    runner.assertTrue(history.size() == 3 && history[2].type == TransactionType::WITHDRAWAL &&
+        history[2].amount == 25.0 && history[0].description == "Initial deposit", "History rebuilt from ledger columns");
+
+    BankAccount busyAccount;
+    for (int i = 0; i < 10000; ++i) {
+        busyAccount.deposit(1.10, i % 2 == 0 ? "Salary" : "Refund");
+    }
+    busyAccount.withdraw(0.10, "Fee");
+    const TransactionLedger& ledger = busyAccount.getLedger();
+    runner.assertEqual(static_cast<size_t>(10001), ledger.size(), "Ledger spans multiple chunks");
+    runner.assertEqual(static_cast<size_t>(3), ledger.getDescriptionCount(), "Ledger interns repeated descriptions");
+    runner.assertTrue(ledger.descriptionAt(4097) == "Refund" && ledger.typeAt(10000) == TransactionType::WITHDRAWAL,
+        "Ledger rows readable across chunk boundaries");
+    runner.assertEqual(10999.90, busyAccount.getBalance(), "Integer cents keep balance exact");
+}
+
+void testLedgerRangeQueries(SimpleTestRunner& runner) {
+    TransactionLedger ledger;
+    for (int day = 0; day < 10000; ++day) {
+        std::time_t timestamp = 1000000 + day * 86400;
+        ledger.append(TransactionType::DEPOSIT, 1000, "Salary", timestamp);
+        if (day % 4 == 0) {
+            ledger.append(TransactionType::WITHDRAWAL, 250, "Rent", timestamp + 3600);
+        }
+    }
+
+    std::time_t from = 1000000 + 100 * 86400;
+    std::time_t to = 1000000 + 200 * 86400;
+    TransactionSummary window = ledger.summarize(from, to);
+    runner.assertEqual(static_cast<size_t>(100), window.depositCount, "Deposits counted in time window");
+    runner.assertEqual(static_cast<size_t>(25), window.withdrawalCount, "Withdrawals counted in time window");
+    runner.assertEqual(static_cast<int64_t>(100000), window.depositCents, "Deposits summed in time window");
+    runner.assertEqual(static_cast<int64_t>(6250), window.withdrawalCents, "Withdrawals summed in time window");
+
+    TransactionSummary everything = ledger.summarize(0, 1LL << 40);
+    runner.assertEqual(ledger.getDepositCents(), everything.depositCents, "Whole-range summary matches running total");
+    runner.assertEqual(static_cast<size_t>(0), ledger.summarize(to, from).depositCount, "Empty window summarizes to zero");
+
+    auto rent = ledger.list(from, to, TransactionType::WITHDRAWAL);
+    runner.assertTrue(rent.size() == 25 && rent.front().description == "Rent" && rent.front().timestamp >= from,
+        "List filters window by type");
+
+    TransactionLedger small;
+    small.append(TransactionType::DEPOSIT, 100, "Opening", 0);
+    runner.assertTrue(small.getChunkCapacity() == 16 && ledger.getChunkCapacity() >= ledger.size() &&
+                      ledger.getChunkCapacity() < 2 * ledger.size() + 16,
+        "Chunks start small and grow geometrically");
+
+    TransactionLedger skewed;
+    skewed.append(TransactionType::DEPOSIT, 100, "First", 500);
+    runner.assertThrows<std::invalid_argument>([&]() {
+        skewed.append(TransactionType::WITHDRAWAL, 30, "Clock stepped back", 400);
+    }, "Out-of-order timestamp is rejected");
+    runner.assertTrue(skewed.size() == 1 && skewed.getWithdrawalCents() == 0 && skewed.getDescriptionCount() == 1,
+        "Rejected row leaves the ledger unchanged");
+    skewed.append(TransactionType::DEPOSIT, 100, "Same second", 500);
+    runner.assertTrue(skewed.orderedTimestamp(400) == 500 && skewed.orderedTimestamp(600) == 600 &&
+                      skewed.nextTimestamp() >= 500,
+        "Ordered timestamps never go below the last row");
+}
+
+void testStatementRendering(SimpleTestRunner& runner) {
+    bool matchesReference = true;
+    std::time_t start = 1700000000; // mid-November 2023
+    for (std::time_t offset = 0; offset < 3 * 86400; offset += 3541) {
+        Transaction transaction(offset % 2 ? TransactionType::DEPOSIT : TransactionType::WITHDRAWAL,
+                                (offset % 100000) / 100.0, "Row", start + offset);
+        if (transaction.toString() != transaction.toStringReference()) {
+            matchesReference = false;
+        }
+    }
+    for (double amount : {0.125, 2.675, 0.005, -0.001, 1e20}) {
+        Transaction halfway(TransactionType::DEPOSIT, amount, "Halfway", start);
+        if (halfway.toString() != halfway.toStringReference()) {
+            matchesReference = false;
+        }
+    }
+    Transaction current(TransactionType::DEPOSIT, 1234567.89, "Bonus");
+    runner.assertTrue(matchesReference && current.toString() == current.toStringReference(),
+        "Cached renderer matches stringstream formatting");
+
+    std::string extreme;
+    StatementRenderer::appendAmount(extreme, std::numeric_limits<int64_t>::min());
+    runner.assertEqual(std::string("-92233720368547758.08"), extreme, "Most negative cents amount renders without overflow");
+
+    BankAccount account(10.0);
+    account.deposit(2.5, "Coffee refund");
+    account.withdraw(0.05, "Fee");
+    std::stringstream statement;
+    {
+        StatementWriter writer(statement);
+        writer.writeLedger(account.getLedger());
+        runner.assertEqual(static_cast<size_t>(3), writer.getRowsWritten(), "Statement writer counts rows");
+    }
+
+    std::string expected;
+    for (const auto& transaction : account.getTransactionHistory()) {
+        expected += transaction.toStringReference() + "\n";
+    }
+    runner.assertEqual(expected, statement.str(), "Streamed statement matches per-row formatting");
+}
+
+void testConcurrentBankAccount(SimpleTestRunner& runner) {
+    ConcurrentBankAccount account(100.0);
+    const int threadCount = 4;
+    const int operationsPerThread = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&account]() {
+            for (int i = 0; i < operationsPerThread; ++i) {
+                account.deposit(1.00, "Top-up");
+                account.withdraw(0.50, "Purchase");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    runner.assertEqual(2100.0, account.getBalance(), "Concurrent deposits and withdrawals keep exact balance");
+    runner.assertEqual(static_cast<size_t>(1 + 2 * threadCount * operationsPerThread), account.getTransactionCount(),
+        "Every operation reaches the ledger");
+    runner.assertEqual(4100.0, account.getTotalDeposits(), "Ledger deposit total after drain");
+
+    ConcurrentBankAccount scarce(100.0);
+    std::atomic<int> successfulWithdrawals{0};
+    threads.clear();
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&scarce, &successfulWithdrawals]() {
+            for (int i = 0; i < 50; ++i) {
+                try {
+                    scarce.withdraw(1.00);
+                    successfulWithdrawals++;
+                } catch (const std::runtime_error&) {
+                    // Insufficient funds
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    runner.assertEqual(100, successfulWithdrawals.load(), "Funds check never lets balance go negative");
+    runner.assertEqual(0.0, scarce.getBalance(), "Contended account drained exactly to zero");
+
+    ConcurrentBankAccount writeOnly;
+    for (int i = 0; i < 5000; ++i) {
+        writeOnly.deposit(1.00, "Top-up");
+    }
+    runner.assertTrue(writeOnly.getPendingLogEntries() < 1024, "Writers drain the log before it grows unbounded");
+    runner.assertEqual(static_cast<size_t>(5000), writeOnly.getTransactionCount(), "Writer-drained rows reach the ledger");
+}
+
+void testAccountStore(SimpleTestRunner& runner) {
+    AccountStore store(1000, 10000, 8);
+
+    runner.assertTrue(store.transfer(1, 2, 2500) == TransferStatus::COMPLETED, "Transfer between accounts");
+    runner.assertEqual(static_cast<int64_t>(7500), store.getBalanceCents(1), "Source account debited");
+    runner.assertEqual(static_cast<int64_t>(12500), store.getBalanceCents(2), "Target account credited");
+    runner.assertTrue(store.transfer(1, 2, 100000) == TransferStatus::INSUFFICIENT_FUNDS, "Overdrawing transfer rejected");
+    runner.assertTrue(store.transfer(1, 5000, 100) == TransferStatus::UNKNOWN_ACCOUNT, "Unknown account rejected");
+    runner.assertTrue(store.transfer(3, 3, 100) == TransferStatus::SAME_ACCOUNT, "Self transfer rejected");
+    runner.assertTrue(store.transfer(1, 9, 100) == TransferStatus::COMPLETED, "Transfer within one shard");
+
+    std::vector<TransferRequest> batch;
+    for (uint64_t i = 0; i < 20000; ++i) {
+        batch.push_back({(i * 7) % 1000, (i * 13 + 1) % 1000, static_cast<int64_t>(1 + i % 500)});
+    }
+    WorkStealingPool pool(4);
+    auto results = store.processBatch(batch, pool);
+    runner.assertEqual(batch.size(), results.size(), "Batch returns one status per transfer");
+    runner.assertEqual(static_cast<int64_t>(1000 * 10000), store.getTotalBalanceCents(), "Parallel transfers conserve money");
+
+    AccountStoreStats stats = store.getStats();
+    runner.assertEqual(static_cast<uint64_t>(batch.size() + 5), stats.completed + stats.rejected, "Stats count every transfer");
+
+    const int64_t nearMax = std::numeric_limits<int64_t>::max() - 10;
+    AccountStore rich(2, nearMax, 2);
+    runner.assertTrue(rich.transfer(0, 1, 100) == TransferStatus::BALANCE_OVERFLOW, "Overflowing credit rejected");
+    runner.assertTrue(rich.getBalanceCents(0) == nearMax && rich.getBalanceCents(1) == nearMax,
+        "Rejected overflow leaves both balances unchanged");
+}
+
+void testDurableBankAccount(SimpleTestRunner& runner) {
+    const std::string prefix = uniqueTempPath("chapter15-durable-test");
+    DurableBankAccount::removeFiles(prefix);
+
+    auto recordsOnDisk = [&prefix]() {
+        size_t records = 0;
+        WriteAheadLog::replay(prefix + ".wal", 0, [&records](const WriteAheadLog::Record&) { records++; });
+        return records;
+    };
+
+    {
+        DurableBankAccount account(prefix);
+        account.deposit(100.0, "Opening");
+        runner.assertEqual(static_cast<size_t>(1), recordsOnDisk(), "Deposit is on disk when it returns");
+        account.withdraw(30.0, "Rent");
+        runner.assertThrows<std::runtime_error>([&]() {
+            account.withdraw(500.0);
+        }, "Durable account rejects overdraw");
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        runner.assertEqual(70.0, account.getBalance(), "Balance recovered from write-ahead log");
+        runner.assertEqual(static_cast<size_t>(2), account.getReplayedRecordCount(), "Rejected operation was never logged");
+        account.snapshot();
+        account.deposit(5.0, "Interest");
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        runner.assertEqual(75.0, account.getBalance(), "Balance recovered from snapshot plus tail");
+        runner.assertEqual(static_cast<size_t>(1), account.getReplayedRecordCount(), "Recovery replays only the tail");
+        runner.assertTrue(account.getRecentHistory().descriptionAt(0) == "Interest", "Replayed record keeps its description");
+    }
+
+    {
+        std::ofstream torn(prefix + ".wal", std::ios::binary | std::ios::app);
+        torn << "partial record";
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        runner.assertEqual(75.0, account.getBalance(), "Torn log tail is ignored");
+        account.deposit(25.0);
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        runner.assertEqual(100.0, account.getBalance(), "Log usable after torn tail is cut off");
+    }
+
+    {
+        GroupCommitPolicy policy;
+        policy.maxBatchRecords = 1000;
+        policy.maxDelay = std::chrono::milliseconds(2);
+        policy.waitForSync = false;
+        DurableBankAccount account(prefix, policy);
+        account.deposit(1.0, "Lone deposit");
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (account.getSyncCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        runner.assertTrue(account.getSyncCount() == 1,
+            "Background flusher commits a lone write-behind record");
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        size_t before = recordsOnDisk();
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&account]() {
+                for (int i = 0; i < 25; ++i) {
+                    account.deposit(1.0, "Concurrent");
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        runner.assertTrue(account.getBalance() == 201.0 && recordsOnDisk() == before + 100,
+            "Concurrent group-committed deposits are all durable on return");
+    }
+
+    {
+        DurableBankAccount account(prefix);
+        account.snapshot();
+    }
+    std::filesystem::resize_file(prefix + ".wal", 0);
+    runner.assertThrows<std::runtime_error>([&]() {
+        DurableBankAccount account(prefix);
+    }, "Snapshot beyond the end of the log fails recovery");
+
+    DurableBankAccount::removeFiles(prefix);
+}
+
+void testStringCalculator(SimpleTestRunner& runner) {
+    StringCalculator calculator;
+
+    runner.assertEqual(0, calculator.add(""), "Empty string returns zero");
+    runner.assertEqual(1, calculator.add("1"), "Single number");
+    runner.assertEqual(3, calculator.add("1,2"), "Two numbers");
+    runner.assertEqual(6, calculator.add("1,2,3"), "Three numbers");
+    runner.assertEqual(6, calculator.add("1\n2,3"), "New line delimiter");
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        calculator.add("1,-2");
+    }, "Negative numbers throw exception");
+
+    runner.assertEqual(12, calculator.add(" +5,\t7"), "Blanks and plus sign accepted");
+    runner.assertEqual(7, calculator.add("3abc,,x,4"), "Junk tokens and empty tokens skipped");
+
+    try {
+        calculator.add("1,-2,3,-5");
+        runner.assertTrue(false, "Negatives listed in error message");
+    } catch (const std::runtime_error& error) {
+        runner.assertEqual(std::string("Negatives not allowed: -2, -5"), std::string(error.what()), "Negatives listed in error message");
+    }
+
+    runner.assertThrows<std::out_of_range>([&]() {
+        calculator.add("99999999999");
+    }, "Out-of-range number throws exception");
+
+    runner.assertThrows<std::overflow_error>([&]() {
+        calculator.add("2147483647,1");
+    }, "Sum overflow detected");
+
+    bool matchesReference = true;
+    for (const std::string input : {"", "0", "1,2,3", "10\n20,30", " 4 , 5 ", "7x,8", "+9", "-0,1", ",,,", "12\r\n13"}) {
+        if (calculator.add(input) != calculator.addReference(input)) {
+            matchesReference = false;
+        }
+    }
+    runner.assertTrue(matchesReference, "Streaming parser matches reference implementation");
+
+    std::string large;
+    for (int i = 0; i < 5000; ++i) {
+        large += std::to_string(i % 1000) + (i % 3 ? "," : "\n");
+    }
+    std::istringstream chunkedInput(large);
+    runner.assertEqual(static_cast<long long>(calculator.add(large)), calculator.addStream(chunkedInput, 3, 64),
+        "Chunked stream sum matches whole-input sum");
+
+    std::istringstream longTokens("123456789,987654321,5");
+    runner.assertEqual(1111111115LL, calculator.addStream(longTokens, 2, 4), "Tokens longer than a chunk carried over");
+
+    std::istringstream bigSum("2147483647,2147483647,10");
+    runner.assertEqual(4294967304LL, calculator.addStream(bigSum), "Stream mode sums beyond int range");
+
+    try {
+        std::istringstream withNegatives("1,-1,2,-2,3,-3,4,-4");
+        calculator.addStream(withNegatives, 4, 3);
+        runner.assertTrue(false, "Chunked negatives reported in input order");
+    } catch (const std::runtime_error& error) {
+        runner.assertEqual(std::string("Negatives not allowed: -1, -2, -3, -4"), std::string(error.what()),
+            "Chunked negatives reported in input order");
+    }
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        calculator.addFile("missing-numbers-file.txt");
+    }, "Missing input file throws exception");
+
+    runner.assertEqual(3, calculator.add("//;\n1;2"), "Single custom delimiter");
+    runner.assertEqual(6, calculator.add("//[***]\n1***2***3"), "Multi-character delimiter");
+    runner.assertEqual(6, calculator.add("//[*][%]\n1*2%3"), "Several custom delimiters");
+    runner.assertEqual(10, calculator.add("//[;][;;]\n1;;2;3,4"), "Longest delimiter wins and defaults still apply");
+    runner.assertEqual(6, calculator.add("//[***]\n3***3"), "Repeated header reuses compiled delimiters");
+
+    runner.assertThrows<std::runtime_error>([&]() {
+        calculator.add("//;\n1;-2");
+    }, "Negatives rejected with custom delimiter");
+
+    runner.assertThrows<std::invalid_argument>([&]() {
+        calculator.add("//[***\n1***2");
+    }, "Malformed delimiter header throws exception");
+
+    int sum = calculator.add("//[***]\n1***1"); // compiles and caches the header
+    runner.assertMaxAllocations(0, [&]() {
+        sum = calculator.add("1,2,3\n4") + calculator.add("//[***]\n3***3");
+    }, "Parsing default and cached custom delimiters does not allocate");
+
+    std::istringstream customStream("//[::]\n1::2::3,4\n5");
+    runner.assertEqual(15LL, calculator.addStream(customStream, 2, 4), "Stream mode honours delimiter header");
+
+    // Custom-only input must still split into small chunks and parse the same
+    bool chunkedCustomMatches = true;
+    for (const char* header : {"//;\n", "//[***]\n", "//[*][**][***]\n", "//[ab][a]\n"}) {
+        std::string body;
+        const char* separators[] = {";", "***", "**", "*", "ab", "a"};
+        for (int i = 0; i < 300; ++i) {
+            body += std::to_string(i * 7 % 1000) + separators[i % 6];
+        }
+        std::string input = header + body;
+        long long expected = -1;
+        try {
+            expected = calculator.add(input);
+        } catch (const std::exception&) {
+        }
+        for (size_t chunkBytes : {1, 3, 7, 64}) {
+            std::istringstream stream(input);
+            long long actual = -1;
+            try {
+                actual = calculator.addStream(stream, 3, chunkBytes);
+            } catch (const std::exception&) {
+            }
+            chunkedCustomMatches = chunkedCustomMatches && actual == expected;
+        }
+    }
+    runner.assertTrue(chunkedCustomMatches, "Custom-delimited stream splits into chunks and matches add()");
+
+    for (const char* header : {"//0\n1", "//-\n1", "//+\n1", "// \n1", "//[a1]\n1"}) {
+        runner.assertThrows<std::invalid_argument>([&]() {
+            calculator.add(header);
+        }, std::string("Delimiter header rejected: ") + Shrink::quote(header));
+    }
+
+    // Header caches are per thread, so a shared calculator stays correct
+    std::atomic<bool> sharedCorrect{true};
+    std::vector<std::thread> threads;
+    const char* inputs[] = {"//;\n1;2;3", "//[**]\n1**2**3", "//%\n1%2%3", "1,2,3"};
+    for (const char* input : inputs) {
+        threads.emplace_back([&calculator, &sharedCorrect, input]() {
+            for (int i = 0; i < 2000; ++i) {
+                if (calculator.add(input) != 6) {
+                    sharedCorrect = false;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    runner.assertTrue(sharedCorrect.load(), "Calculator shared between threads with different headers");
+}
+
+// Property tests: the fast paths must agree with the reference implementations
+// on random inputs, not just on the hand-written cases above
+void testStringCalculatorProperties(SimpleTestRunner& runner) {
+    StringCalculator calculator;
+
+    // Outcome as text, so a sum and an error message compare the same way
+    auto outcome = [](auto&& run) -> std::string {
+        try {
+            return "sum " + std::to_string(run());
+        } catch (const std::overflow_error&) {
+            return "overflow";
+        } catch (const std::out_of_range&) {
+            return "out of range";
+        } catch (const std::runtime_error& error) {
+            return error.what();
+        }
+    };
+
+    const std::string alphabet = "0123456789012345,,,\n\n-+ x";
+    runner.checkProperty("StringCalculator::add matches addReference",
+        [&](std::mt19937_64& random) {
+            std::string input(random() % 24, ' ');
+            for (char& c : input) {
+                c = alphabet[random() % alphabet.size()];
+            }
+            return input;
+        },
+        [&](const std::string& input) {
+            std::string fast = outcome([&]() { return calculator.add(input); });
+            // The reference sums in int and overflows silently, so it has no
+            // answer to compare against once the fast path reports overflow
+            return fast == "overflow" || fast == outcome([&]() { return calculator.addReference(input); });
+        },
+        [](const std::string& input) { return Shrink::string(input, "0,"); },
+        Shrink::quote);
+}
+
+void testPasswordValidatorProperties(SimpleTestRunner& runner) {
+    PasswordValidator validator;
+    const char* seeds[] = {"password", "Password123", "qwerty", "letmein", "abc123"};
+
+    runner.checkProperty("validatePassword matches validatePasswordReference",
+        [&](std::mt19937_64& random) {
+            std::string password;
+            if (random() % 4 == 0) {
+                password = seeds[random() % 5]; // near-misses of common passwords
+                for (char& c : password) {
+                    if (random() % 3 == 0) {
+                        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                    }
+                }
+            }
+            size_t extra = random() % 16;
+            for (size_t i = 0; i < extra; ++i) {
+                password += static_cast<char>(random() % 8 == 0 ? random() % 256 : 0x20 + random() % 95);
+            }
+            return password;
+        },
+        [&](const std::string& password) {
+            return validator.validatePassword(password).toString() ==
+                   validator.validatePasswordReference(password).toString();
+        },
+        [](const std::string& password) { return Shrink::string(password, "a"); },
+        Shrink::quote);
+}
+
+struct AccountOperation {
+    bool isDeposit;
+    int64_t cents; // may be zero, negative or more than the balance
+};
+
+void testBankAccountProperties(SimpleTestRunner& runner) {
+    using Operations = std::vector<AccountOperation>;
+
+    // The account, its lock-free variant and a plain model must agree on every
+    // outcome and on the final balance, history and totals
+    runner.checkProperty("BankAccount and ConcurrentBankAccount match a model",
+        [](std::mt19937_64& random) {
+            Operations operations(random() % 24);
+            for (auto& operation : operations) {
+                operation.isDeposit = random() % 2 == 0;
+                operation.cents = static_cast<int64_t>(random() % 20000) - 2000;
+            }
+            return operations;
+        },
+        [](const Operations& operations) {
+            BankAccount account(10.0);
+            ConcurrentBankAccount concurrent(10.0);
+            int64_t modelCents = 1000;
+            int64_t depositCents = 1000;
+            int64_t withdrawalCents = 0;
+            size_t transactions = 1;
+
+            auto outcome = [](auto&& run) -> int {
+                try {
+                    run();
+                    return 0;
+                } catch (const std::invalid_argument&) {
+                    return 1;
+                } catch (const std::runtime_error&) {
+                    return 2;
+                }
+            };
+
+            for (const auto& operation : operations) {
+                double amount = operation.cents / 100.0;
+                int expected = operation.cents <= 0 ? 1 : (!operation.isDeposit && operation.cents > modelCents ? 2 : 0);
+                int actual = outcome([&]() {
+                    operation.isDeposit ? account.deposit(amount) : account.withdraw(amount);
+                });
+                int concurrentActual = outcome([&]() {
+                    operation.isDeposit ? concurrent.deposit(amount) : concurrent.withdraw(amount);
+                });
+                if (actual != expected || concurrentActual != expected) {
+                    return false;
+                }
+                if (expected == 0) {
+                    modelCents += operation.isDeposit ? operation.cents : -operation.cents;
+                    (operation.isDeposit ? depositCents : withdrawalCents) += operation.cents;
+                    ++transactions;
+                }
+            }
+
+            TransactionSummary summary = account.summarizeBetween(0, std::numeric_limits<std::time_t>::max());
+            return account.getBalance() == modelCents / 100.0 &&
+                   concurrent.getBalance() == modelCents / 100.0 &&
+                   account.getLedger().size() == transactions &&
+                   concurrent.getTransactionCount() == transactions &&
+                   account.getTotalDeposits() == depositCents / 100.0 &&
+                   concurrent.getTotalWithdrawals() == withdrawalCents / 100.0 &&
+                   summary.depositCents == depositCents &&
+                   summary.withdrawalCents == withdrawalCents;
+        },
+        [](const Operations& operations) {
+            std::vector<Operations> candidates = Shrink::removals(operations);
+            for (size_t i = 0; i < operations.size(); ++i) {
+                if (operations[i].cents > 1 || operations[i].cents < 0) {
+                    Operations smaller = operations;
+                    smaller[i].cents = operations[i].cents < 0 ? 0 : operations[i].cents / 2;
+                    candidates.push_back(std::move(smaller));
+                }
+            }
+            return candidates;
+        },
+        [](const Operations& operations) {
+            std::string text = "[";
+            for (const auto& operation : operations) {
+                text += (text.size() > 1 ? ", " : "");
+                text += (operation.isDeposit ? "deposit " : "withdraw ") + std::to_string(operation.cents);
+            }
+            return text + "]";
+        });
+}
+
+void testPerformanceGates(SimpleTestRunner& runner) {
+    struct alignas(64) CacheLine {
+        uint64_t words[8];
+    };
+    size_t alignedAllocations = AllocationCounter::countAllocations([]() {
+        std::vector<CacheLine> lines(4);
+        Bench::doNotOptimize(lines);
+    });
+    runner.assertEqual(static_cast<size_t>(1), alignedAllocations, "Over-aligned allocations are counted");
+
+    const std::string path = uniqueTempPath("chapter15-baseline") + ".json";
+    {
+        std::ofstream json(path);
+        json << "{\n  \"benchmarks\": [\n"
+             << "    {\"name\": \"Cart::add (batch)\", \"iterations\": 1, \"samples\": 1, \"min_ns\": 4.00, \"median_ns\": 5.00, \"p99_ns\": 6.00},\n"
+             << "    {\"name\": \"Cart::add\", \"iterations\": 1, \"samples\": 1, \"min_ns\": 90.00, \"median_ns\": 100.00, \"p99_ns\": 110.00}\n"
+             << "  ]\n}\n";
+    }
+    runner.assertTrue(SimpleTestRunner::readBaselineMedian(path, "Cart::add") == 100.0 &&
+                      SimpleTestRunner::readBaselineMedian(path, "Cart::add (batch)") == 5.0 &&
+                      !SimpleTestRunner::readBaselineMedian(path, "Cart"),
+        "Baseline lookup matches whole benchmark names only");
+
+    std::ostringstream quiet;
+    SimpleTestRunner gated(quiet);
+    gated.assertFasterThan(path, "Cart::remove", []() {}, 0.5);
+    runner.assertEqual(1, gated.getFailedCount(), "Gate without a baseline entry fails");
+    std::remove(path.c_str());
+}
+
+void testWorkStealingPool(SimpleTestRunner& runner) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> runs(1000);
+    std::mutex idsMutex;
+    std::vector<std::thread::id> threadIds;
+    for (int round = 0; round < 3; ++round) {
+        pool.run(runs.size(), [&](size_t index) {
+            runs[index]++;
+            std::lock_guard<std::mutex> lock(idsMutex);
+            if (std::find(threadIds.begin(), threadIds.end(), std::this_thread::get_id()) == threadIds.end()) {
+                threadIds.push_back(std::this_thread::get_id());
+            }
+        });
+    }
+    runner.assertTrue(std::all_of(runs.begin(), runs.end(), [](const std::atomic<int>& count) { return count == 3; }),
+        "Every task runs once per run");
+    runner.assertTrue(threadIds.size() <= pool.getThreadCount(), "Runs reuse the pool's threads");
+
+    int small = 0;
+    pool.run(1, [&](size_t) { small++; });
+    pool.run(0, [&](size_t) { small++; });
+    runner.assertEqual(1, small, "Runs smaller than the pool complete");
+
+    std::atomic<int> completed{0};
+    runner.assertThrows<std::runtime_error>([&]() {
+        pool.run(100, [&](size_t index) {
+            if (index == 42) {
+                throw std::runtime_error("task failed");
+            }
+            completed++;
+        });
+    }, "Task exception is rethrown by run()");
+    runner.assertEqual(99, completed.load(), "Other tasks finish despite the exception");
+}
+
+// Performance Demos
+void benchmarkDivideErrorHandling() {
+    const size_t count = 200000;
+    Calculator calculator;
+    std::vector<double> dividends(count, 10.0), divisors(count), result(count);
+    std::mt19937_64 random(48);
+
+    std::cout << "Dividing " << count << " pairs (ns/element):" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (double zeroShare : {0.0, 0.01, 0.5}) {
+        for (double& divisor : divisors) {
+            divisor = std::uniform_real_distribution<double>(0.0, 1.0)(random) < zeroShare ? 0.0 : 4.0;
+        }
+        auto nanosecondsPerElement = [&](auto&& body) {
+            auto start = std::chrono::steady_clock::now();
+            body();
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+        };
+
+        double throwing = nanosecondsPerElement([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                try {
+                    result[i] = calculator.divide(dividends[i], divisors[i]);
+                } catch (const std::runtime_error&) {
+                    result[i] = 0.0;
+                }
+            }
+        });
+        double expected = nanosecondsPerElement([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                result[i] = calculator.tryDivide(dividends[i], divisors[i]).valueOr(0.0);
+            }
+        });
+        size_t zeros = 0;
+        double bulk = nanosecondsPerElement([&]() {
+            zeros = calculator.divide(dividends, divisors, result);
+        });
+        std::cout << "  " << std::setw(3) << static_cast<int>(zeroShare * 100) << "% zero divisors ("
+                  << zeros << "): throwing " << throwing << ", tryDivide " << expected
+                  << ", bulk " << bulk << std::endl;
+    }
+}
+
+void benchmarkCalculatorBulk() {
+    const size_t counts[] = {4096, 4 * 1024 * 1024}; // cache-resident and memory-bound
+    volatile double sink = 0.0;
+
+    for (size_t count : counts) {
+        std::vector<double> a(count, 1.5), b(count, 2.5), result(count);
+        const int repeats = static_cast<int>(std::max<size_t>(4, (64u << 20) / (count * sizeof(double))));
+        auto gigabytesPerSecond = [&](size_t bytesPerRepeat, auto&& body) {
+            body();
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < repeats; ++r) {
+                body();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return static_cast<double>(bytesPerRepeat) * repeats / seconds / 1e9;
+        };
+
+        std::cout << "Bulk Calculator over " << count << " doubles (GB/s):" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        double loopAdd = gigabytesPerSecond(3 * count * sizeof(double), [&]() {
+            Calculator scalarCalculator;
+            for (size_t i = 0; i < count; ++i) {
+                result[i] = scalarCalculator.add(a[i], b[i]);
+            }
+            sink = sink + result[count / 2];
+        });
+        double accumulateTotal = gigabytesPerSecond(count * sizeof(double), [&]() {
+            sink = sink + std::accumulate(a.begin(), a.end(), 0.0);
+        });
+        std::cout << "  Per-call loop:  add " << loopAdd << ", std::accumulate total " << accumulateTotal << std::endl;
+
+        for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detectSimdLevel()) {
+                continue;
+            }
+            Calculator calculator(level);
+            double add = gigabytesPerSecond(3 * count * sizeof(double), [&]() {
+                calculator.add(a, b, result);
+                sink = sink + result[count / 2];
+            });
+            double divide = gigabytesPerSecond(3 * count * sizeof(double), [&]() {
+                sink = sink + static_cast<double>(calculator.divide(a, b, result));
+            });
+            double total = gigabytesPerSecond(count * sizeof(double), [&]() {
+                sink = sink + calculator.calculateTotal(a);
+            });
+            std::cout << "  " << std::left << std::setw(14) << (std::string(simdLevelName(level)) + ":") << std::right
+                      << "add " << add << ", divide " << divide << ", total " << total << std::endl;
+        }
+    }
+}
+
+void benchmarkBreachedPasswordLookup() {
+    std::vector<uint64_t> hashes(1000000);
+    uint64_t state = 42;
+    for (auto& hash : hashes) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        hash = state;
+    }
+    auto built = BreachedPasswordIndex::fromHashes(std::move(hashes));
+
+    // Loading maps the files instead of reading them, so it costs the same at any size
+    const std::string path = uniqueTempPath("chapter15-breached-bench") + ".idx";
+    built.save(path, path + ".hashes");
+    auto start = std::chrono::steady_clock::now();
+    auto index = BreachedPasswordIndex::load(path, path + ".hashes");
+    double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const int lookups = 200000;
+    std::vector<std::string> candidates;
+    for (int i = 0; i < 1000; ++i) {
+        candidates.push_back("CandidatePassword" + std::to_string(i));
+    }
+
+    volatile int hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        hits = hits + index.contains(candidates[i % candidates.size()]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Breached-password index (" << index.size() << " entries, "
+              << (index.isMemoryMapped() ? "mapped" : "read into memory") << "): load "
+              << std::fixed << std::setprecision(1) << loadSeconds * 1e6 << " us, lookup "
+              << seconds * 1e9 / lookups << " ns" << std::endl;
+    std::remove(path.c_str());
+    std::remove((path + ".hashes").c_str());
+}
+
+void benchmarkPasswordValidator() {
+    PasswordValidator validator;
+    std::vector<std::string> passwords;
+    for (int i = 0; i < 10000; ++i) {
+        passwords.push_back((i % 3 == 0 ? "weakpassword" : "Str0ng!Passphrase") + std::to_string(i));
+    }
+
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& password : passwords) {
+        sink = sink + validator.validatePasswordReference(password).getErrorCount();
     }
-};
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-class BankAccount {
-private:
-    double balance;
-    std::vector<Transaction> transactions;
+    start = std::chrono::steady_clock::now();
+    auto results = validator.validatePasswords(passwords);
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sink = sink + results.size();
 
-public:
-    explicit BankAccount(double initialBalance = 0) : balance(initialBalance) {
-        if (initialBalance < 0) {
-            throw std::invalid_argument("Initial balance cannot be negative");
+    size_t referenceAllocations = AllocationCounter::countAllocations([&]() {
+        for (const auto& password : passwords) {
+            sink = sink + validator.validatePasswordReference(password).isValid();
         }
-        
-        if (initialBalance > 0) {
-            transactions.emplace_back(TransactionType::DEPOSIT, initialBalance, "Initial deposit");
+    });
+    size_t fastAllocations = AllocationCounter::countAllocations([&]() {
+        for (const auto& password : passwords) {
+            sink = sink + validator.validatePassword(password).isValid();
         }
+    });
+
+    std::cout << "Password validation (" << passwords.size() << " passwords):" << std::endl;
+    std::cout << "  Multi-pass reference: " << static_cast<long long>(passwords.size() / referenceSeconds) << " passwords/sec" << std::endl;
+    std::cout << "  Single-pass batch:    " << static_cast<long long>(passwords.size() / batchSeconds) << " passwords/sec" << std::endl;
+    std::cout << "  Allocations per password: reference " << std::fixed << std::setprecision(1)
+              << static_cast<double>(referenceAllocations) / passwords.size() << ", single-pass "
+              << static_cast<double>(fastAllocations) / passwords.size() << std::endl;
+}
+
+
+// Forwards to an upstream resource and counts how often it is asked for memory
+class CountingMemoryResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    size_t allocations = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return upstream->allocate(bytes, alignment);
     }
 
-    double getBalance() const {
-        return balance;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        upstream->deallocate(pointer, bytes, alignment);
     }
 
-    const std::vector<Transaction>& getTransactionHistory() const {
-        return transactions;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
     }
 
-    void deposit(double amount, const std::string& description = "Deposit") {
-        if (amount <= 0) {
-            throw std::invalid_argument("Deposit amount must be positive");
-        }
+public:
+    explicit CountingMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream) {}
 
-        balance += amount;
-        transactions.emplace_back(TransactionType::DEPOSIT, amount, description);
+    size_t getAllocations() const { return allocations; }
+};
+
+// One simulated request: build a cart, read its total, throw it away
+double handleCartRequest(std::pmr::memory_resource* resource, const std::vector<std::string>& itemNames) {
+    ShoppingCart cart(resource);
+    for (size_t i = 0; i < itemNames.size(); ++i) {
+        cart.addItem(itemNames[i], 1.0 + i % 5, 1);
     }
+    return cart.getTotal();
+}
 
-    void withdraw(double amount, const std::string& description = "Withdrawal") {
-        if (amount <= 0) {
-            throw std::invalid_argument("Withdrawal amount must be positive");
-        }
+void benchmarkRequestArena() {
+    const int requests = 2000;
+    std::vector<std::string> itemNames;
+    for (int i = 0; i < 200; ++i) {
+        itemNames.push_back("Catalog item number " + std::to_string(i));
+    }
 
-        if (amount > balance) {
-            throw std::runtime_error("Insufficient funds");
-        }
+    volatile double sink = 0;
 
-        balance -= amount;
-        transactions.emplace_back(TransactionType::WITHDRAWAL, amount, description);
+    CountingMemoryResource heap;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+        sink = sink + handleCartRequest(&heap, itemNames);
     }
+    double heapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    double getTotalDeposits() const {
-        double total = 0;
-        for (const auto& transaction : transactions) {
-            if (transaction.type == TransactionType::DEPOSIT) {
-                total += transaction.amount;
-            }
-        }
-        return total;
-    }
+    CountingMemoryResource arenaUpstream;
+    std::vector<std::byte> arenaBuffer(64 * 1024);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+        std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size(), &arenaUpstream);
+        sink = sink + handleCartRequest(&arena, itemNames);
+    } // arena released here, all at once
+    double arenaSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    double getTotalWithdrawals() const {
-        double total = 0;
-        for (const auto& transaction : transactions) {
-            if (transaction.type == TransactionType::WITHDRAWAL) {
-                total += transaction.amount;
+    std::cout << "Per-request cart of " << itemNames.size() << " items:" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  Heap:  " << static_cast<double>(heap.getAllocations()) / requests << " allocator calls, "
+              << heapSeconds * 1e6 / requests << " us/request" << std::endl;
+    std::cout << "  Arena: " << static_cast<double>(arenaUpstream.getAllocations()) / requests << " allocator calls, "
+              << arenaSeconds * 1e6 / requests << " us/request" << std::endl;
+}
+
+template<typename Cart>
+double measureConcurrentAdds(int threadCount, int itemsPerThread) {
+    Cart cart;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&cart, itemsPerThread]() {
+            for (int i = 0; i < itemsPerThread; ++i) {
+                cart.addItem("Widget", 1.25);
             }
-        }
-        return total;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
     }
-};
 
-// Example 5: String Calculator (TDD Kata)
-class StringCalculator {
-public:
-    int add(const std::string& numbers) {
-        if (numbers.empty()) {
-            return 0;
-        }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
 
-        std::vector<int> parsedNumbers;
-        std::vector<int> negatives;
+void benchmarkConcurrentShoppingCart() {
+    const int threadCount = 4;
+    const int itemsPerThread = 50000;
+    const double totalAdds = threadCount * itemsPerThread;
 
-        // Replace newlines with commas for uniform parsing
-        std::string normalizedNumbers = numbers;
-        std::replace(normalizedNumbers.begin(), normalizedNumbers.end(), '\n', ',');
+    double mutexSeconds = measureConcurrentAdds<MutexShoppingCart>(threadCount, itemsPerThread);
+    double shardedSeconds = measureConcurrentAdds<ConcurrentShoppingCart>(threadCount, itemsPerThread);
 
-        std::stringstream ss(normalizedNumbers);
-        std::string numberString;
+    std::cout << "Shared cart, " << threadCount << " threads:" << std::endl;
+    std::cout << "  Mutex baseline: " << static_cast<long long>(totalAdds / mutexSeconds) << " adds/sec" << std::endl;
+    std::cout << "  Sharded/atomic: " << static_cast<long long>(totalAdds / shardedSeconds) << " adds/sec" << std::endl;
+}
 
-        while (std::getline(ss, numberString, ',')) {
-            if (!numberString.empty()) {
-                try {
-                    int number = std::stoi(numberString);
-                    if (number < 0) {
-                        negatives.push_back(number);
-                    } else {
-                        parsedNumbers.push_back(number);
-                    }
-                } catch (const std::invalid_argument&) {
-                    // Ignore invalid numbers
-                }
-            }
+void benchmarkShoppingCartLookup() {
+    std::cout << "Indexed cart lookups (hasItem + getTotal + remove/re-add):" << std::endl;
+    for (int size : {10, 1000, 100000}) {
+        ShoppingCart cart;
+        for (int i = 0; i < size; ++i) {
+            cart.addItem("Item" + std::to_string(i), 1.0 + i % 7, 1);
         }
 
-        if (!negatives.empty()) {
-            std::string errorMessage = "Negatives not allowed: ";
-            for (size_t i = 0; i < negatives.size(); ++i) {
-                if (i > 0) errorMessage += ", ";
-                errorMessage += std::to_string(negatives[i]);
+        const int operations = 100000;
+        volatile double sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < operations; ++i) {
+            std::string name = "Item" + std::to_string(i % size);
+            if (cart.hasItem(name)) {
+                cart.removeItem(name);
+                cart.addItem(name, 2.0, 1);
             }
-            throw std::runtime_error(errorMessage);
+            sink = sink + cart.getTotal() + cart.getItemCount();
         }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        return std::accumulate(parsedNumbers.begin(), parsedNumbers.end(), 0);
+        std::cout << "  " << std::setw(6) << size << " items: "
+                  << std::fixed << std::setprecision(0) << seconds * 1e9 / operations << " ns/op" << std::endl;
     }
-};
+}
 
-// Simple Test Framework for C++
-class SimpleTestRunner {
-private:
-    int testsPassed = 0;
-    int testsFailed = 0;
+void benchmarkAccountContention() {
+    const int threadCount = 4;
+    const int operationsPerThread = 50000;
+    const double totalOperations = 2.0 * threadCount * operationsPerThread;
 
-public:
-    void assertTrue(bool condition, const std::string& testName) {
-        if (condition) {
-            std::cout << "✅ " << testName << std::endl;
-            testsPassed++;
-        } else {
-            std::cout << "❌ " << testName << std::endl;
-            testsFailed++;
+    auto hammer = [&](std::vector<std::unique_ptr<ConcurrentBankAccount>>& accounts) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            ConcurrentBankAccount& account = *accounts[t % accounts.size()];
+            threads.emplace_back([&account, operationsPerThread]() {
+                for (int i = 0; i < operationsPerThread; ++i) {
+                    account.deposit(1.00);
+                    account.withdraw(1.00);
+                }
+            });
         }
-    }
-
-    template<typename T>
-    void assertEqual(const T& expected, const T& actual, const std::string& testName) {
-        if (expected == actual) {
-            std::cout << "✅ " << testName << std::endl;
-            testsPassed++;
-        } else {
-            std::cout << "❌ " << testName << " - Expected: " << expected << ", Actual: " << actual << std::endl;
-            testsFailed++;
+        for (auto& thread : threads) {
+            thread.join();
         }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<std::unique_ptr<ConcurrentBankAccount>> hotAccount;
+    hotAccount.push_back(std::make_unique<ConcurrentBankAccount>(100.0));
+    double hotSeconds = hammer(hotAccount);
+
+    std::vector<std::unique_ptr<ConcurrentBankAccount>> spreadAccounts;
+    for (int t = 0; t < threadCount; ++t) {
+        spreadAccounts.push_back(std::make_unique<ConcurrentBankAccount>(100.0));
     }
+    double spreadSeconds = hammer(spreadAccounts);
 
-    template<typename ExceptionType, typename Func>
-    void assertThrows(Func&& func, const std::string& testName) {
-        try {
-            func();
-            std::cout << "❌ " << testName << " - Expected exception was not thrown" << std::endl;
-            testsFailed++;
-        } catch (const ExceptionType&) {
-            std::cout << "✅ " << testName << std::endl;
-            testsPassed++;
-        } catch (const std::exception& ex) {
-            std::cout << "❌ " << testName << " - Wrong exception type: " << ex.what() << std::endl;
-            testsFailed++;
+    std::cout << "Account contention, " << threadCount << " threads:" << std::endl;
+    std::cout << "  One hot account:     " << static_cast<long long>(totalOperations / hotSeconds) << " ops/sec" << std::endl;
+    std::cout << "  One account/thread:  " << static_cast<long long>(totalOperations / spreadSeconds) << " ops/sec" << std::endl;
+}
+
+// Zipf-distributed account ids: a few hot accounts receive most of the traffic
+class ZipfGenerator {
+private:
+    std::vector<double> cumulative;
+    std::mt19937_64 engine;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+public:
+    ZipfGenerator(size_t count, double exponent, uint64_t seed) : engine(seed) {
+        cumulative.reserve(count);
+        double sum = 0;
+        for (size_t rank = 1; rank <= count; ++rank) {
+            sum += 1.0 / std::pow(static_cast<double>(rank), exponent);
+            cumulative.push_back(sum);
+        }
+        for (auto& value : cumulative) {
+            value /= sum;
         }
     }
 
-    void printSummary() {
-        int total = testsPassed + testsFailed;
-        double successRate = total > 0 ? (testsPassed * 100.0 / total) : 0.0;
-
-        std::cout << "\n=== Test Summary ===" << std::endl;
-        std::cout << "Passed: " << testsPassed << std::endl;
-        std::cout << "Failed: " << testsFailed << std::endl;
-        std::cout << "Total: " << total << std::endl;
-        std::cout << "Success Rate: " << std::fixed << std::setprecision(1) << successRate << "%" << std::endl;
+    uint64_t next() {
+        auto it = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(engine));
+        return static_cast<uint64_t>(std::min<size_t>(it - cumulative.begin(), cumulative.size() - 1));
     }
 };
 
-// Test Functions
-void testCalculator(SimpleTestRunner& runner) {
-    Calculator calculator;
+void benchmarkAccountStore() {
+    const size_t accountCount = 100000;
+    const size_t transferCount = 400000;
 
-    runner.assertEqual(8.0, calculator.add(5, 3), "Add two positive numbers");
-    runner.assertEqual(2.0, calculator.subtract(5, 3), "Subtract two numbers");
-    runner.assertEqual(15.0, calculator.multiply(5, 3), "Multiply two numbers");
-    runner.assertEqual(2.0, calculator.divide(6, 3), "Divide two numbers");
+    ZipfGenerator zipf(accountCount, 0.99, 7);
+    std::vector<TransferRequest> batch;
+    batch.reserve(transferCount);
+    while (batch.size() < transferCount) {
+        uint64_t from = zipf.next();
+        uint64_t to = zipf.next();
+        if (from != to) {
+            batch.push_back({from, to, 100});
+        }
+    }
 
-    runner.assertThrows<std::runtime_error>([&]() {
-        calculator.divide(5, 0);
-    }, "Divide by zero throws exception");
+    std::cout << "Account store, " << transferCount << " Zipfian transfers over " << accountCount << " accounts:" << std::endl;
+    for (size_t threads : {1, 4}) {
+        AccountStore store(accountCount, 1000000);
+        WorkStealingPool pool(threads);
+        auto start = std::chrono::steady_clock::now();
+        store.processBatch(batch, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    std::vector<double> numbers = {1.0, 2.0, 3.0, 4.0};
-    runner.assertEqual(10.0, calculator.calculateTotal(numbers), "Calculate total of array");
+        AccountStoreStats stats = store.getStats();
+        std::cout << "  " << threads << " thread(s): " << static_cast<long long>(transferCount / seconds) << " transfers/sec, "
+                  << "avg " << std::fixed << std::setprecision(0) << stats.averageLatencyNanos << " ns, "
+                  << "max " << stats.maxLatencyNanos / 1000 << " us" << std::endl;
+    }
 }
 
-void testShoppingCart(SimpleTestRunner& runner) {
-    ShoppingCart cart;
+void benchmarkDurableBankAccount() {
+    const std::string prefix = (std::filesystem::temp_directory_path() / "chapter15-durable-bench").string();
 
-    runner.assertEqual(static_cast<size_t>(0), cart.getItemTypes(), "New cart is empty");
-    runner.assertEqual(0.0, cart.getTotal(), "Empty cart total is zero");
+    // 16 callers each wait for their own record to be fsynced; a bigger batch
+    // lets more of them share one fsync
+    std::cout << "Durable account commit throughput (16 writers, synchronous):" << std::endl;
+    const int writers = 16;
+    const int operationsPerWriter = 125;
+    for (size_t batchSize : {1, 16, 256}) {
+        DurableBankAccount::removeFiles(prefix);
+        GroupCommitPolicy policy{batchSize, std::chrono::microseconds(500)};
 
-    cart.addItem("Apple", 1.50, 2);
-    runner.assertEqual(static_cast<size_t>(1), cart.getItemTypes(), "Cart has one item type");
-    runner.assertEqual(3.00, cart.getTotal(), "Cart total with one item");
-    runner.assertEqual(2, cart.getItemCount(), "Cart item count");
+        auto start = std::chrono::steady_clock::now();
+        uint64_t syncs = 0;
+        {
+            DurableBankAccount account(prefix, policy, 0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < writers; ++t) {
+                threads.emplace_back([&account]() {
+                    for (int i = 0; i < operationsPerWriter; ++i) {
+                        account.deposit(1.00);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            syncs = account.getSyncCount();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    cart.addItem("Banana", 0.75, 3);
-    runner.assertEqual(5.25, cart.getTotal(), "Cart total with multiple items");
+        std::cout << "  batch " << std::setw(3) << batchSize << ": "
+                  << static_cast<long long>(writers * operationsPerWriter / seconds)
+                  << " commits/sec (" << syncs << " fsyncs)" << std::endl;
+    }
 
-    runner.assertTrue(cart.hasItem("Apple"), "Cart contains added item");
-    runner.assertTrue(!cart.hasItem("Orange"), "Cart doesn't contain non-added item");
+    const int history = 200000;
+    DurableBankAccount::removeFiles(prefix);
+    {
+        DurableBankAccount account(prefix, GroupCommitPolicy{4096, std::chrono::seconds(1), false}, 0);
+        for (int i = 0; i < history; ++i) {
+            account.deposit(1.00, "Deposit");
+            if (i == history - 1000) {
+                account.snapshot();
+            }
+        }
+    }
 
-    runner.assertThrows<std::invalid_argument>([&]() {
-        cart.addItem("Invalid", -1.0);
-    }, "Negative price throws exception");
-}
+    auto start = std::chrono::steady_clock::now();
+    DurableBankAccount recovered(prefix, GroupCommitPolicy{}, 0);
+    double snapshotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-void testPasswordValidator(SimpleTestRunner& runner) {
-    PasswordValidator validator;
+    std::filesystem::remove(prefix + ".snapshot");
+    start = std::chrono::steady_clock::now();
+    DurableBankAccount replayedInFull(prefix, GroupCommitPolicy{}, 0);
+    double fullSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    auto result = validator.validatePassword("short");
-    runner.assertTrue(!result.isValid(), "Short password is invalid");
+    std::cout << "  Recovery of " << history << " records: full replay " << std::fixed << std::setprecision(1)
+              << fullSeconds * 1000 << " ms, snapshot + " << recovered.getReplayedRecordCount() << "-record tail "
+              << snapshotSeconds * 1000 << " ms" << std::endl;
+    DurableBankAccount::removeFiles(prefix);
+}
 
-    result = validator.validatePassword("password123");
-    runner.assertTrue(!result.isValid(), "Password without uppercase is invalid");
+void benchmarkStatementRendering() {
+    BankAccount account;
+    for (int i = 0; i < 200000; ++i) {
+        account.deposit(12.34, i % 2 ? "Card payment" : "Transfer");
+    }
+    std::vector<Transaction> history = account.getTransactionHistory();
 
-    result = validator.validatePassword("Password123!");
-    runner.assertTrue(result.isValid(), "Valid password passes validation");
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& transaction : history) {
+        sink = sink + transaction.toStringReference().size();
+    }
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    result = validator.validatePassword("password");
-    runner.assertTrue(!result.isValid(), "Common password is invalid");
-}
+    std::ostringstream statement;
+    start = std::chrono::steady_clock::now();
+    {
+        StatementWriter writer(statement);
+        writer.writeLedger(account.getLedger());
+    }
+    double writerSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-void testBankAccount(SimpleTestRunner& runner) {
-    BankAccount account(100.0);
-    runner.assertEqual(100.0, account.getBalance(), "Initial balance set correctly");
+    std::cout << "Statement export (" << history.size() << " rows):" << std::endl;
+    std::cout << "  stringstream + localtime: " << static_cast<long long>(history.size() / referenceSeconds) << " rows/sec" << std::endl;
+    std::cout << "  StatementWriter:          " << static_cast<long long>(history.size() / writerSeconds) << " rows/sec" << std::endl;
+}
 
-    account.deposit(50.0);
-    runner.assertEqual(150.0, account.getBalance(), "Balance after deposit");
+void benchmarkLedgerRangeQueries() {
+    const size_t rows = 2000000;
+    TransactionLedger ledger;
+    for (size_t i = 0; i < rows; ++i) {
+        ledger.append(i % 3 ? TransactionType::DEPOSIT : TransactionType::WITHDRAWAL, 100 + i % 900, "Row",
+                      static_cast<std::time_t>(1000000 + i * 15));
+    }
 
-    account.withdraw(25.0);
-    runner.assertEqual(125.0, account.getBalance(), "Balance after withdrawal");
+    std::mt19937_64 engine(11);
+    std::uniform_int_distribution<std::time_t> pick(1000000, 1000000 + static_cast<std::time_t>(rows) * 15);
+    const int queries = 20;
+    std::vector<std::pair<std::time_t, std::time_t>> windows;
+    for (int i = 0; i < queries; ++i) {
+        std::time_t a = pick(engine);
+        std::time_t b = pick(engine);
+        windows.emplace_back(std::min(a, b), std::max(a, b));
+    }
 
-    runner.assertThrows<std::runtime_error>([&]() {
-        account.withdraw(200.0);
-    }, "Overdraw throws exception");
+    volatile int64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& window : windows) {
+        int64_t deposits = 0;
+        for (size_t i = 0; i < ledger.size(); ++i) {
+            std::time_t timestamp = ledger.timestampAt(i);
+            if (timestamp >= window.first && timestamp < window.second && ledger.typeAt(i) == TransactionType::DEPOSIT) {
+                deposits += ledger.amountCentsAt(i);
+            }
+        }
+        sink = sink + deposits;
+    }
+    double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    runner.assertThrows<std::invalid_argument>([&]() {
-        account.deposit(-10.0);
-    }, "Negative deposit throws exception");
+    start = std::chrono::steady_clock::now();
+    for (const auto& window : windows) {
+        sink = sink + ledger.summarize(window.first, window.second).depositCents;
+    }
+    double indexedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    runner.assertThrows<std::invalid_argument>([&]() {
-        BankAccount(-50.0);
-    }, "Negative initial balance throws exception");
+    std::cout << "Deposits-in-window over " << rows << " transactions:" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Full scan:           " << scanSeconds * 1e6 / queries << " us/query" << std::endl;
+    std::cout << "  Prefix-sum + search: " << indexedSeconds * 1e6 / queries << " us/query" << std::endl;
 }
 
-void testStringCalculator(SimpleTestRunner& runner) {
+void benchmarkStringCalculator() {
+    std::string input;
+    std::mt19937 engine(3);
+    std::uniform_int_distribution<int> number(0, 9999);
+    while (input.size() < 8 * 1024 * 1024) {
+        input += std::to_string(number(engine) % 100);
+        input += (input.size() % 7 == 0) ? '\n' : ',';
+    }
+
     StringCalculator calculator;
+    volatile int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    sink = sink + calculator.addReference(input);
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    runner.assertEqual(0, calculator.add(""), "Empty string returns zero");
-    runner.assertEqual(1, calculator.add("1"), "Single number");
-    runner.assertEqual(3, calculator.add("1,2"), "Two numbers");
-    runner.assertEqual(6, calculator.add("1,2,3"), "Three numbers");
-    runner.assertEqual(6, calculator.add("1\n2,3"), "New line delimiter");
+    start = std::chrono::steady_clock::now();
+    sink = sink + calculator.add(input);
+    double streamingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    runner.assertThrows<std::runtime_error>([&]() {
-        calculator.add("1,-2");
-    }, "Negative numbers throw exception");
+    double megabytes = input.size() / (1024.0 * 1024.0);
+    std::cout << "String calculator (" << std::fixed << std::setprecision(0) << megabytes << " MB input):" << std::endl;
+    std::cout << "  stringstream + stoi: " << megabytes / referenceSeconds << " MB/s" << std::endl;
+    std::cout << "  single-pass parser:  " << megabytes / streamingSeconds << " MB/s" << std::endl;
+
+    std::string customInput = "//[;;][|]\n";
+    for (char c : input) {
+        if (c == ',') customInput += ";;";
+        else if (c == '\n') customInput += '|';
+        else customInput += c;
+    }
+    start = std::chrono::steady_clock::now();
+    sink = sink + calculator.add(customInput);
+    double customSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  custom delimiters:   " << customInput.size() / (1024.0 * 1024.0) / customSeconds << " MB/s" << std::endl;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "chapter15-numbers.txt").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        for (int i = 0; i < 4; ++i) {
+            file << input;
+        }
+    }
+    for (size_t threads : {1, 4}) {
+        start = std::chrono::steady_clock::now();
+        volatile long long total = calculator.addFile(path, threads);
+        (void)total;
+        double fileSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  file mode, " << threads << " thread(s): " << megabytes * 4 / fileSeconds << " MB/s" << std::endl;
+    }
+    std::filesystem::remove(path);
 }
 
 void demonstrateTDDProcess() {
@@ -560,7 +5344,165 @@ void demonstrateTDDProcess() {
     std::cout << std::endl;
 }
 
-int main() {
+// Performance regression gates for the hot paths, checked against a baseline
+// file produced earlier with --benchmark-json
+void runPerformanceGates(SimpleTestRunner& runner, const std::string& baselineFile) {
+    const double tolerance = 0.5; // shared machines are noisy, so only flag large regressions
+
+    ShoppingCart cart;
+    cart.addItem("Apple", 1.25, 2);
+    cart.addItem("Banana", 0.75, 3);
+    runner.assertFasterThan(baselineFile, "ShoppingCart::getTotal", [&]() {
+        Bench::doNotOptimize(cart);
+        Bench::doNotOptimize(cart.getTotal());
+    }, tolerance);
+
+    PasswordValidator validator;
+    const std::string strongPassword = "Correct-Horse-42";
+    runner.assertFasterThan(baselineFile, "PasswordValidator::validatePassword (valid)", [&]() {
+        Bench::doNotOptimize(validator.validatePassword(strongPassword));
+    }, tolerance);
+
+    StringCalculator stringCalculator;
+    std::string input;
+    for (int i = 0; i < 100; ++i) {
+        input += std::to_string(i * 37 % 1000) + (i % 10 == 9 ? "\n" : ",");
+    }
+    runner.assertFasterThan(baselineFile, "StringCalculator::add (100 numbers)", [&]() {
+        Bench::doNotOptimize(stringCalculator.add(input));
+    }, tolerance);
+}
+
+// Per-operation baselines for every example class, reported through the
+// runner's benchmark harness so they can be tracked from run to run
+void runMicrobenchmarks(SimpleTestRunner& runner) {
+    Calculator calculator;
+    std::vector<double> numbers(1024);
+    std::iota(numbers.begin(), numbers.end(), 1.0);
+    double a = 1234.5;
+    double b = 6.75;
+    runner.benchmark("Calculator::add", [&]() {
+        Bench::doNotOptimize(a);
+        Bench::doNotOptimize(b);
+        Bench::doNotOptimize(calculator.add(a, b));
+    });
+    runner.benchmark("Calculator::divide", [&]() {
+        Bench::doNotOptimize(a);
+        Bench::doNotOptimize(b);
+        Bench::doNotOptimize(calculator.divide(a, b));
+    });
+    runner.benchmark("Calculator::calculateTotal (1024 values)", [&]() {
+        Bench::doNotOptimize(calculator.calculateTotal(numbers));
+    });
+
+    ShoppingCart cart;
+    const std::string productNames[] = {"Apple", "Banana", "Cherry", "Date"};
+    size_t cartAdds = 0;
+    runner.benchmark("ShoppingCart::addItem", [&]() {
+        if (++cartAdds % 4096 == 0) {
+            cart.clear(); // keeps capacity, so the cart does not grow without bound
+        }
+        cart.addItem(productNames[cartAdds % 4], 1.25, 2);
+    });
+    runner.benchmark("ShoppingCart::getTotal", [&]() {
+        Bench::doNotOptimize(cart);
+        Bench::doNotOptimize(cart.getTotal());
+    });
+
+    PasswordValidator validator;
+    const std::string strongPassword = "Correct-Horse-42";
+    const std::string weakPassword = "password";
+    runner.benchmark("PasswordValidator::validatePassword (valid)", [&]() {
+        Bench::doNotOptimize(validator.validatePassword(strongPassword));
+    });
+    runner.benchmark("PasswordValidator::validatePassword (common)", [&]() {
+        Bench::doNotOptimize(validator.validatePassword(weakPassword));
+    });
+
+    std::optional<BankAccount> account;
+    size_t accountOperations = 0;
+    runner.benchmark("BankAccount::deposit + withdraw", [&]() {
+        if (accountOperations++ % 4096 == 0) {
+            account.emplace(1000.0); // fresh ledger keeps memory use flat
+        }
+        account->deposit(12.34);
+        account->withdraw(12.34);
+    });
+
+    StringCalculator stringCalculator;
+    std::string input;
+    for (int i = 0; i < 100; ++i) {
+        input += std::to_string(i * 37 % 1000) + (i % 10 == 9 ? "\n" : ",");
+    }
+    const std::string customInput = "//[***][;]\n1***2;3,4\n5***6;7";
+    runner.benchmark("StringCalculator::add (100 numbers)", [&]() {
+        Bench::doNotOptimize(stringCalculator.add(input));
+    });
+    runner.benchmark("StringCalculator::add (custom delimiters)", [&]() {
+        Bench::doNotOptimize(stringCalculator.add(customInput));
+    });
+}
+
+int main(int argc, char* argv[]) {
+    // Index builder: --build-password-index <list.txt> <out> writes <out> (the
+    // filter) and <out>.hashes (the optional exact-confirmation file)
+    if (argc > 1 && std::string(argv[1]) == "--build-password-index") {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --build-password-index <password-list.txt> <index-file>" << std::endl;
+            return 2;
+        }
+        try {
+            auto index = BreachedPasswordIndex::fromTextFile(argv[2]);
+            index.save(argv[3], std::string(argv[3]) + ".hashes");
+            std::cout << "Indexed " << index.size() << " passwords into " << argv[3]
+                      << " and " << argv[3] << ".hashes" << std::endl;
+            return 0;
+        } catch (const std::exception& ex) {
+            std::cerr << "Cannot build password index: " << ex.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // The default run is tests only; --bench adds the benchmark suite and
+    // --benchmark-json implies it, since the file holds microbenchmark results
+    PropertyConfig properties;
+    std::string benchmarkJsonPath;
+    std::string baselinePath;
+    bool runBenchmarks = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench") {
+            runBenchmarks = true;
+            continue;
+        }
+        if (arg != "--property-budget-ms" && arg != "--seed" && arg != "--benchmark-json" && arg != "--baseline") {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--bench] [--benchmark-json <file>] [--baseline <file>]"
+                      << " [--property-budget-ms <ms>] [--seed <n>]" << std::endl;
+            return 2;
+        }
+        if (i + 1 == argc) {
+            std::cerr << arg << " needs a value" << std::endl;
+            return 2;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--property-budget-ms") {
+                properties.timeBudget = std::chrono::milliseconds(std::stoll(value));
+            } else if (arg == "--seed") {
+                properties.seed = std::stoull(value);
+            } else if (arg == "--benchmark-json") {
+                benchmarkJsonPath = value;
+                runBenchmarks = true;
+            } else {
+                baselinePath = value;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid number for " << arg << ": " << value << std::endl;
+            return 2;
+        }
+    }
+
     std::cout << "=== Testing & TDD Demo ===" << std::endl << std::endl;
 
     // Demonstrate TDD process
@@ -569,22 +5511,64 @@ int main() {
     // Run tests
     SimpleTestRunner runner;
 
-    std::cout << "--- Calculator Tests ---" << std::endl;
-    testCalculator(runner);
-
-    std::cout << "\n--- Shopping Cart Tests ---" << std::endl;
-    testShoppingCart(runner);
+    runner.registerTest("Calculator Tests", "testCalculator", testCalculator);
+    runner.registerTest("Shopping Cart Tests", "testShoppingCart", testShoppingCart);
+    runner.registerTest("Shopping Cart Tests", "testConcurrentShoppingCart", testConcurrentShoppingCart);
+    runner.registerTest("Password Validator Tests", "testPasswordValidator", testPasswordValidator);
+    runner.registerTest("Password Validator Tests", "testBreachedPasswordIndex", testBreachedPasswordIndex);
+    runner.registerTest("Bank Account Tests", "testBankAccount", testBankAccount);
+    runner.registerTest("Bank Account Tests", "testLedgerRangeQueries", testLedgerRangeQueries);
+    runner.registerTest("Bank Account Tests", "testStatementRendering", testStatementRendering);
+    runner.registerTest("Bank Account Tests", "testConcurrentBankAccount", testConcurrentBankAccount);
+    runner.registerTest("Bank Account Tests", "testAccountStore", testAccountStore);
+    runner.registerTest("Bank Account Tests", "testDurableBankAccount", testDurableBankAccount);
+    runner.registerTest("String Calculator Tests", "testStringCalculator", testStringCalculator);
+    runner.registerTest("Property Tests", "testStringCalculatorProperties", testStringCalculatorProperties);
+    runner.registerTest("Property Tests", "testPasswordValidatorProperties", testPasswordValidatorProperties);
+    runner.registerTest("Property Tests", "testBankAccountProperties", testBankAccountProperties);
+    runner.registerTest("Test Runner Tests", "testPerformanceGates", testPerformanceGates);
+    runner.registerTest("Test Runner Tests", "testWorkStealingPool", testWorkStealingPool);
+    runner.configureProperties(properties);
+    runner.runAll();
+    runner.printSlowestTests();
 
-    std::cout << "\n--- Password Validator Tests ---" << std::endl;
-    testPasswordValidator(runner);
+    // Gates run before the summary so their failures are counted in it
+    if (!baselinePath.empty()) {
+        std::cout << "\n=== Performance Gates ===" << std::endl;
+        bool sameFile = !benchmarkJsonPath.empty() &&
+            std::filesystem::weakly_canonical(baselinePath) == std::filesystem::weakly_canonical(benchmarkJsonPath);
+        runner.assertTrue(!sameFile, "--baseline and --benchmark-json name different files");
+        if (!sameFile) {
+            runPerformanceGates(runner, baselinePath);
+        }
+    }
 
-    std::cout << "\n--- Bank Account Tests ---" << std::endl;
-    testBankAccount(runner);
+    runner.printSummary();
 
-    std::cout << "\n--- String Calculator Tests ---" << std::endl;
-    testStringCalculator(runner);
+    if (runBenchmarks) {
+        std::cout << "\n=== Performance ===" << std::endl;
+        benchmarkCalculatorBulk();
+        benchmarkDivideErrorHandling();
+        benchmarkConcurrentShoppingCart();
+        benchmarkShoppingCartLookup();
+        benchmarkRequestArena();
+        benchmarkPasswordValidator();
+        benchmarkBreachedPasswordLookup();
+        benchmarkAccountContention();
+        benchmarkAccountStore();
+        benchmarkDurableBankAccount();
+        benchmarkStatementRendering();
+        benchmarkLedgerRangeQueries();
+        benchmarkStringCalculator();
 
-    runner.printSummary();
+        std::cout << "\n=== Microbenchmarks ===" << std::endl;
+        runMicrobenchmarks(runner);
+        if (!benchmarkJsonPath.empty()) {
+            std::ofstream json(benchmarkJsonPath);
+            runner.writeBenchmarkJson(json);
+            std::cout << "Benchmark results written to " << benchmarkJsonPath << std::endl;
+        }
+    }
 
     std::cout << "\n=== TDD Benefits ===" << std::endl;
     std::cout << "✓ Catches bugs early in development" << std::endl;
@@ -595,5 +5579,6 @@ int main() {
     std::cout << "✓ Encourages RAII and proper resource management" << std::endl;
     std::cout << "✓ Helps identify interface design issues early" << std::endl;
 
-    return 0;
+    // A failed test or performance gate fails the run
+    return runner.getFailedCount() == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -5,8 +5,36 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <string_view>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
 using namespace std;
 
+// Counts heap allocations so main() can check the calculator makes none
+static size_t allocationCount = 0;
+
+void* operator new(size_t size) {
+    ++allocationCount;
+    if (void* pointer = malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+// Releases what the counting operator new took from malloc
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
 // ❌ BEFORE Refactoring - Poor code structure
 class BadCalculator {
 public:
@@ -35,26 +63,46 @@ enum class Operation {
     ADD, SUBTRACT, MULTIPLY, DIVIDE
 };
 
+enum class CalculationError : uint8_t {
+    NONE, DIVISION_BY_ZERO, UNKNOWN_OPERATION
+};
+
+// An error code instead of a string: the result is 16 trivially copyable
+// bytes, returned in registers, and building one never allocates
 struct CalculationResult {
     double value;
-    bool isSuccess;
-    string errorMessage;
+    CalculationError error;
+    
+    static constexpr string_view MESSAGES[] = {"", "Division by zero", "Unknown operation"};
     
     static CalculationResult success(double val) {
-        return {val, true, ""};
+        return {val, CalculationError::NONE};
     }
     
-    static CalculationResult error(const string& msg) {
-        return {0, false, msg};
+    static CalculationResult failure(CalculationError error) {
+        return {0, error};
+    }
+    
+    bool isSuccess() const {
+        return error == CalculationError::NONE;
+    }
+    
+    string_view errorMessage() const {
+        size_t index = static_cast<size_t>(error);
+        return index < sizeof(MESSAGES) / sizeof(MESSAGES[0]) ? MESSAGES[index] : "Unknown error";
     }
 };
 
-class Calculator {
+static_assert(is_trivially_copyable_v<CalculationResult>, "CalculationResult must stay trivially copyable");
+
+// First refactoring: a hash map of std::function. Kept to benchmark against
+// the switch below, which avoids the hash lookup and type-erased call.
+class FunctionMapCalculator {
 private:
     unordered_map<Operation, function<CalculationResult(double, double)>> operations;
     
 public:
-    Calculator() {
+    FunctionMapCalculator() {
         operations[Operation::ADD] = [](double a, double b) {
             return CalculationResult::success(a + b);
         };
@@ -67,7 +115,7 @@ public:
         operations[Operation::DIVIDE] = [](double a, double b) {
             return b != 0 
                 ? CalculationResult::success(a / b)
-                : CalculationResult::error("Division by zero");
+                : CalculationResult::failure(CalculationError::DIVISION_BY_ZERO);
         };
     }
     
@@ -76,6 +124,58 @@ public:
     }
 };
 
+// A switch over a dense enum compiles to a jump table (or a few compares), and
+// the compiler can inline the case that a caller uses
+class Calculator {
+public:
+    CalculationResult calculate(Operation operation, double a, double b) const {
+        switch (operation) {
+            case Operation::ADD:
+                return CalculationResult::success(a + b);
+            case Operation::SUBTRACT:
+                return CalculationResult::success(a - b);
+            case Operation::MULTIPLY:
+                return CalculationResult::success(a * b);
+            case Operation::DIVIDE:
+                return b != 0
+                    ? CalculationResult::success(a / b)
+                    : CalculationResult::failure(CalculationError::DIVISION_BY_ZERO);
+        }
+        return CalculationResult::failure(CalculationError::UNKNOWN_OPERATION);
+    }
+};
+
+template<typename Calc>
+double measureCalculationsPerSecond(Calc& calculator, const vector<Operation>& operations, int rounds) {
+    volatile double sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < operations.size(); ++i) {
+            CalculationResult result = calculator.calculate(operations[i], 10.0 + i, 1.0 + (i & 7));
+            sink = sink + result.value;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return operations.size() * static_cast<double>(rounds) / seconds;
+}
+
+void benchmarkDispatch() {
+    vector<Operation> operations;
+    for (int i = 0; i < 4096; ++i) {
+        operations.push_back(static_cast<Operation>((i * 7 + i / 3) % 4));
+    }
+    const int rounds = 500;
+
+    FunctionMapCalculator mapCalc;
+    Calculator switchCalc;
+    double mapRate = measureCalculationsPerSecond(mapCalc, operations, rounds);
+    double switchRate = measureCalculationsPerSecond(switchCalc, operations, rounds);
+
+    cout << fixed << setprecision(1);
+    cout << "   unordered_map + std::function: " << mapRate / 1e6 << "M calculations/sec" << endl;
+    cout << "   switch dispatch:               " << switchRate / 1e6 << "M calculations/sec" << endl;
+}
+
 int main() {
     cout << "🔧 Refactoring Example (C++)" << endl;
     cout << "============================" << endl << endl;
@@ -91,10 +191,24 @@ int main() {
     Calculator goodCalc;
     
     auto result1 = goodCalc.calculate(Operation::ADD, 5, 3);
-    cout << "5 + 3 = " << (result1.isSuccess ? to_string(result1.value) : result1.errorMessage) << endl;
+    cout << "5 + 3 = " << (result1.isSuccess() ? to_string(result1.value) : string(result1.errorMessage())) << endl;
     
     auto result2 = goodCalc.calculate(Operation::DIVIDE, 10, 0);
-    cout << "10 / 0 = " << (result2.isSuccess ? to_string(result2.value) : result2.errorMessage) << endl;
+    cout << "10 / 0 = " << (result2.isSuccess() ? to_string(result2.value) : string(result2.errorMessage())) << endl;
+    
+    // Allocation check: success and error results must not touch the heap
+    double sum = 0;
+    size_t before = allocationCount;
+    for (int i = 0; i < 1000; ++i) {
+        sum += goodCalc.calculate(Operation::MULTIPLY, i, 2).value;
+        sum += goodCalc.calculate(Operation::DIVIDE, i, 0).errorMessage().size();
+    }
+    size_t allocations = allocationCount - before;
+    cout << (allocations == 0 ? "✅" : "❌") << " 2000 calculations made " << allocations
+         << " heap allocations (checksum " << sum << ")" << endl;
+    
+    cout << endl << "⏱️  Dispatch performance:" << endl;
+    benchmarkDispatch();
     
     cout << endl << "💡 Refactoring Benefits:" << endl;
     cout << "   ✓ Better error handling" << endl;
@@ -102,5 +216,5 @@ int main() {
     cout << "   ✓ Easier to extend" << endl;
     cout << "   ✓ More testable" << endl;
     
-    return 0;
+    return allocations == 0 ? 0 : 1;
 }
\ No newline at end of file